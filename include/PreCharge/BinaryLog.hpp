@@ -0,0 +1,205 @@
+#pragma once
+
+#include <EVT/io/UART.hpp>
+#include <EVT/utils/log.hpp>
+#include <PreCharge/LogMessages.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Lowest level compiled into the binary log: 0 DEBUG, 1 INFO, 2 WARNING,
+ * 3 ERROR, 4 nothing. Defaults to everything when the EVT logger is enabled
+ * and nothing otherwise.
+ */
+#ifndef PVC_LOG_LEVEL
+    #ifdef EVT_CORE_LOG_ENABLE
+        #define PVC_LOG_LEVEL 0
+    #else
+        #define PVC_LOG_LEVEL 4
+    #endif
+#endif
+
+namespace IO = EVT::core::IO;
+
+namespace PreCharge::log {
+
+using LogLevel = EVT::core::log::Logger::LogLevel;
+
+/**
+ * IDs of the messages in PVC_LOG_MESSAGES, in order
+ */
+enum class MessageID : uint8_t {
+#define PVC_LOG_ID(name, level, format) name,
+    PVC_LOG_MESSAGES(PVC_LOG_ID)
+#undef PVC_LOG_ID
+        NUM_MESSAGES,
+};
+
+/**
+ * Deferred logger for the control loop.
+ *
+ * log() only copies the message ID, a millisecond timestamp and the raw
+ * arguments into a RAM ring buffer; no formatting or UART traffic happens on
+ * the caller's time. drain() is called from a background task and feeds the
+ * buffer to the UART only while its transmitter is free, so it never waits
+ * on the baud rate either. When the ring is full new messages are dropped
+ * and counted.
+ *
+ * Messages below PVC_LOG_LEVEL are removed at compile time.
+ *
+ * Each message goes on the wire as a frame:
+ *   SYNC, ID, argument count, timestamp (4 bytes), arguments (4 bytes each),
+ *   checksum
+ * with multi-byte values little endian and the checksum the 8 bit sum of
+ * every byte after SYNC. The ring holds the frames exactly as they are sent.
+ * In TEXT format drain() renders each frame as a line instead, for use with
+ * a plain serial terminal.
+ *
+ * Not interrupt safe: log() and drain() must both be called from the main
+ * loop.
+ */
+class BinaryLog {
+public:
+    /**
+     * What drain() writes to the UART
+     */
+    enum class Format {
+        /** Frames as stored, decoded on the host by LogDecoder */
+        BINARY,
+        /** One formatted line per message */
+        TEXT,
+    };
+
+    /**
+     * A decoded frame
+     */
+    struct Record {
+        MessageID id;
+        uint8_t numArgs;
+        /** time::millis() when the message was logged */
+        uint32_t timestamp;
+        int32_t args[11];
+    };
+
+    /** First byte of every frame, never part of a text log line */
+    static constexpr uint8_t SYNC = 0xA5;
+    /** Most arguments a message can have */
+    static constexpr uint8_t MAX_ARGS = sizeof(Record::args) / sizeof(Record::args[0]);
+    /** Bytes in a frame before the arguments */
+    static constexpr size_t HEADER_SIZE = 7;
+    /** Size of the largest frame */
+    static constexpr size_t MAX_FRAME_SIZE = HEADER_SIZE + 4 * MAX_ARGS + 1;
+    /** Size of the ring buffer in bytes, a power of two */
+    static constexpr size_t BUFFER_SIZE = 1024;
+    /** Longest line written in TEXT format */
+    static constexpr size_t MAX_LINE_SIZE = 160;
+
+    /** Level of each message, indexed by MessageID */
+    static constexpr LogLevel LEVELS[] = {
+#define PVC_LOG_LEVEL_OF(name, level, format) LogLevel::level,
+        PVC_LOG_MESSAGES(PVC_LOG_LEVEL_OF)
+#undef PVC_LOG_LEVEL_OF
+    };
+
+    /**
+     * Logs a message, if its level is compiled in
+     *
+     * @tparam id Message to log
+     * @param[in] args Arguments of the message's format, converted to int32_t
+     */
+    template<MessageID id, typename... Args>
+    void log(Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "Too many log arguments");
+        if constexpr (static_cast<int>(LEVELS[static_cast<uint8_t>(id)]) >= PVC_LOG_LEVEL) {
+            const int32_t values[sizeof...(Args) + 1] = {static_cast<int32_t>(args)...};
+            write(id, values, sizeof...(Args));
+        }
+    }
+
+    /**
+     * Writes buffered messages to the UART, stopping as soon as its
+     * transmitter is busy
+     *
+     * @param[in] uart UART to write to
+     * @param[in] budget Most bytes to write in this call
+     * @return Number of bytes written
+     */
+    size_t drain(IO::UART& uart, size_t budget = MAX_FRAME_SIZE);
+
+    /**
+     * Selects what drain() writes. Takes effect from the next message.
+     *
+     * @param[in] newFormat Format to write in
+     */
+    void setFormat(Format newFormat);
+
+    /**
+     * @return Number of messages dropped because the ring was full
+     */
+    uint32_t getDropped() const;
+
+    /**
+     * Decodes the frame at the start of a byte stream
+     *
+     * @param[in] data Bytes to decode
+     * @param[in] size Number of bytes available
+     * @param[out] record Decoded message
+     * @return Length of the frame, 0 if more bytes are needed or -1 if data
+     * does not start with a valid frame
+     */
+    static int32_t parse(const uint8_t* data, size_t size, Record& record);
+
+    /**
+     * Renders a message as a line of text, "[timestamp] LEVEL: message"
+     *
+     * @param[in] record Message to render
+     * @param[out] line Buffer for the line, NUL terminated
+     * @param[in] size Size of the buffer
+     * @return Length of the line without the terminator
+     */
+    static size_t format(const Record& record, char* line, size_t size);
+
+private:
+    static_assert((BUFFER_SIZE & (BUFFER_SIZE - 1)) == 0, "BinaryLog buffer size must be a power of two");
+
+    /** Frames waiting to be drained */
+    uint8_t buffer[BUFFER_SIZE] = {};
+    /** Free running write index into buffer */
+    uint32_t head = 0;
+    /** Free running read index into buffer */
+    uint32_t tail = 0;
+    /** Messages dropped on a full ring */
+    uint32_t dropped = 0;
+
+    /** What drain() writes */
+    Format outputFormat = Format::BINARY;
+    /** The message being written out by drain() */
+    uint8_t pending[MAX_LINE_SIZE] = {};
+    /** Number of bytes in pending */
+    size_t pendingSize = 0;
+    /** Number of bytes of pending already written */
+    size_t pendingPos = 0;
+
+    /**
+     * Stores a frame in the ring
+     *
+     * @param[in] id Message ID
+     * @param[in] args Arguments of the message
+     * @param[in] numArgs Number of arguments
+     */
+    void write(MessageID id, const int32_t* args, uint8_t numArgs);
+
+    /**
+     * Takes the oldest frame out of the ring into pending, in the output
+     * format
+     *
+     * @return false if the ring was empty
+     */
+    bool fillPending();
+};
+
+/** The log used throughout the PreCharge library */
+extern BinaryLog LOGGER;
+
+}// namespace PreCharge::log
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <EVT/io/types/CANMessage.hpp>
+#include <PreCharge/utils/CycleStats.hpp>
+
+#include <cstdint>
+
+namespace IO = EVT::core::IO;
+
+namespace PreCharge {
+
+/**
+ * Acceptance filter and dispatch table for received CAN frames, run from
+ * the CAN receive interrupt.
+ *
+ * Only frames with an ID that was registered are passed on; everything else
+ * on the vehicle bus is rejected before it is copied anywhere. Standard IDs
+ * are looked up in a bitmap covering all 2048 of them and go to a single
+ * handler, the CANopen queue. Extended IDs are looked up in a small hash
+ * table, each with its own handler. Both lookups take constant time however
+ * busy the bus is.
+ *
+ * The bxCAN filter banks are not used as they only reach standard IDs
+ * through IO::CAN::addCANFilter(), and narrowing them would also shut out
+ * the extended SIM100 replies.
+ */
+class CANDispatcher {
+public:
+    /**
+     * Receives frames accepted for it, in interrupt context
+     *
+     * @param[in] message The received frame
+     * @param[in] priv Private data registered with the handler
+     */
+    using Handler = void (*)(IO::CANMessage& message, void* priv);
+
+    /** Maximum number of extended IDs that can be registered */
+    static constexpr uint8_t MAX_EXTENDED_IDS = 8;
+
+    /**
+     * Counters of the frames seen, all updated from the interrupt
+     */
+    struct Stats {
+        /** Frames received */
+        uint32_t received;
+        /** Standard frames accepted */
+        uint32_t standard;
+        /** Extended frames accepted */
+        uint32_t extended;
+        /** Frames rejected by the filter */
+        uint32_t rejected;
+    };
+
+    /**
+     * Accepts a standard ID
+     *
+     * @param[in] id The 11 bit ID
+     */
+    void acceptStandard(uint16_t id);
+
+    /**
+     * Sets the handler of every accepted standard ID
+     *
+     * @param[in] handler Function to call, nullptr to reject standard frames
+     * @param[in] priv Private data passed to the handler
+     */
+    void setStandardHandler(Handler handler, void* priv);
+
+    /**
+     * Accepts an extended ID, passing it to its own handler
+     *
+     * @param[in] id The 29 bit ID
+     * @param[in] handler Function to call
+     * @param[in] priv Private data passed to the handler
+     * @return false if the table is full
+     */
+    bool addExtended(uint32_t id, Handler handler, void* priv);
+
+    /**
+     * Filters a received frame and passes it to its handler. Meant to be
+     * called from the CAN receive interrupt.
+     *
+     * @param[in] message The received frame
+     */
+    void dispatch(IO::CANMessage& message);
+
+    /**
+     * @return Frame counters
+     */
+    const Stats& getStats() const;
+
+    /**
+     * @return Time spent in dispatch(), handlers included, in CycleCounter
+     * ticks
+     */
+    const CycleStats& getDispatchStats() const;
+
+private:
+    /** log2 of the number of slots in the extended ID hash table */
+    static constexpr uint8_t HASH_BITS = 4;
+    /** Slots in the hash table, twice MAX_EXTENDED_IDS to keep probes short */
+    static constexpr uint8_t HASH_SIZE = 1u << HASH_BITS;
+
+    /**
+     * A registered extended ID
+     */
+    struct Slot {
+        uint32_t id;
+        Handler handler;
+        void* priv;
+    };
+
+    /** One bit per standard ID, set if accepted */
+    uint32_t standardMask[2048 / 32] = {};
+    /** Handler of the accepted standard IDs */
+    Handler standardHandler = nullptr;
+    /** Private data of the standard handler */
+    void* standardPriv = nullptr;
+
+    /** Extended ID hash table, open addressing with linear probing */
+    Slot slots[HASH_SIZE] = {};
+    /** Number of extended IDs registered */
+    uint8_t numExtended = 0;
+    /** Longest probe sequence of any registered ID, bounding a lookup */
+    uint8_t maxProbe = 0;
+
+    Stats stats = {};
+    CycleStats dispatchStats = {};
+
+    /**
+     * @param[in] id 29 bit ID
+     * @return Home slot of the ID in the hash table
+     */
+    static uint8_t hash(uint32_t id);
+};
+
+}// namespace PreCharge
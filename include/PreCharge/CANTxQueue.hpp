@@ -0,0 +1,129 @@
+#pragma once
+
+#include <EVT/io/CAN.hpp>
+#include <EVT/io/types/CANMessage.hpp>
+#include <PreCharge/utils/CycleStats.hpp>
+
+#include <cstdint>
+
+namespace IO = EVT::core::IO;
+
+namespace PreCharge {
+
+/**
+ * Software transmit queue in front of IO::CAN, so the state machine never
+ * waits on the transmit mailboxes.
+ *
+ * Frames are queued by priority and put on the bus by drain(), highest
+ * priority first and oldest first within a priority. On target, drain()
+ * checks the bxCAN transmit mailboxes before each frame, as transmit() waits
+ * for one to free up when they are all taken. It stops once none is free, or
+ * at the first frame the CAN peripheral does not take, and leaves the frame
+ * at the head of its queue for the next drain(), so nothing is reordered or
+ * lost when the mailboxes are full and drain() never waits on the bus.
+ *
+ * A frame queued with coalescing replaces a pending frame of the same ID and
+ * priority in place, keeping its position and enqueue time, so a status that
+ * changed twice before the bus was free only goes out once, with its latest
+ * value. A frame that finds its priority full is dropped and counted.
+ */
+class CANTxQueue {
+public:
+    /**
+     * Transmit priority, lower values go out first
+     */
+    enum class Priority : uint8_t {
+        /** Frames other nodes act on to keep the vehicle safe */
+        SAFETY = 0u,
+        /** State reports such as the change PDO */
+        STATE = 1u,
+        /** Anything that can wait */
+        DIAGNOSTIC = 2u
+    };
+
+    /** Number of priorities */
+    static constexpr uint8_t NUM_PRIORITIES = 3;
+    /** Frames that can be pending per priority */
+    static constexpr uint8_t CAPACITY = 8;
+
+    /**
+     * Counters of the queue, for every priority together
+     */
+    struct Stats {
+        /** Frames pending */
+        uint32_t depth;
+        /** Largest depth seen */
+        uint32_t maxDepth;
+        /** Frames put on the bus */
+        uint32_t sent;
+        /** Frames dropped as their priority was full */
+        uint32_t dropped;
+        /** Frames that replaced a pending frame instead of being queued */
+        uint32_t coalesced;
+    };
+
+    /**
+     * @param[in] can CAN interface frames are transmitted on
+     */
+    explicit CANTxQueue(IO::CAN& can);
+
+    /**
+     * Queues a frame
+     *
+     * @param[in] message Frame to send, copied
+     * @param[in] priority Priority of the frame
+     * @param[in] coalesce Replace a pending frame with the same ID instead of
+     * queueing another one
+     * @return false if the frame was dropped
+     */
+    bool enqueue(IO::CANMessage& message, Priority priority, bool coalesce);
+
+    /**
+     * Transmits pending frames until the queue is empty or the CAN
+     * peripheral stops accepting them
+     *
+     * @return Number of frames transmitted
+     */
+    uint8_t drain();
+
+    /**
+     * @return Queue counters
+     */
+    const Stats& getStats() const;
+
+    /**
+     * @return Time from enqueue() to the frame being handed to the CAN
+     * peripheral, in CycleCounter ticks
+     */
+    const CycleStats& getLatencyStats() const;
+
+private:
+    /**
+     * A queued frame
+     */
+    struct Entry {
+        IO::CANMessage message;
+        /** CycleCounter::now() when the frame was queued */
+        uint32_t enqueueTime;
+    };
+
+    /** CAN interface frames are transmitted on */
+    IO::CAN& can;
+    /** Ring of pending frames per priority */
+    Entry entries[NUM_PRIORITIES][CAPACITY] = {};
+    /** Oldest pending frame of each priority */
+    uint8_t heads[NUM_PRIORITIES] = {};
+    /** Number of pending frames of each priority */
+    uint8_t counts[NUM_PRIORITIES] = {};
+
+    Stats stats = {};
+    CycleStats latency = {};
+
+    /**
+     * @return true if transmit() can hand a frame to the peripheral without
+     * waiting, always true on the host
+     */
+    static bool mailboxFree();
+};
+
+}// namespace PreCharge
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <EVT/io/CAN.hpp>
+#include <EVT/io/types/CANMessage.hpp>
+#include <PreCharge/utils/SPSCQueue.hpp>
+#include <co_core.h>
+
+#include <cstdint>
+
+namespace IO = EVT::core::IO;
+
+namespace PreCharge {
+
+/**
+ * Receive queue between the CAN interrupt and the CANopen stack, in place of
+ * EVT-core's FixedQueue of CANMessage.
+ *
+ * Frames are stored compactly: the 11 bit ID and the length share one
+ * 16 bit word in front of the payload, 10 bytes a frame. The ring is an
+ * SPSCQueue, so the interrupt and CONodeProcess() never lock each other
+ * out, and a frame that finds it full is counted as an overrun instead of
+ * disappearing silently.
+ *
+ * getDriver() fills in a CANopen stack CAN driver reading from the queue and
+ * transmitting straight on the CAN interface, like EVT-core's own driver.
+ * As the stack's driver functions take no context, only one queue can back
+ * a driver at a time.
+ */
+class CANopenQueue {
+public:
+    /** Frames the queue holds, a power of two */
+    static constexpr uint32_t SIZE = 32;
+
+    /**
+     * A queued frame
+     */
+    struct Frame {
+        /** ID from bit 4 up, length in the lower 4 bits */
+        uint16_t header;
+        uint8_t data[8];
+    };
+
+    /** Overrun and high water counters */
+    using Stats = SPSCQueue<Frame, SIZE>::Stats;
+
+    /**
+     * Adds a received frame. Must only be called from the CAN interrupt. A
+     * frame that finds the queue full is dropped and counted in the overruns
+     * of getStats(), which is all canHandler() reports of it.
+     *
+     * @param[in] message The received frame, standard ID
+     * @return false if the queue was full and the frame was dropped
+     */
+    bool push(IO::CANMessage& message);
+
+    /**
+     * Removes the oldest frame. Must only be called by the CANopen stack's
+     * side.
+     *
+     * @param[out] frame The frame, in the stack's format
+     * @return false if the queue was empty
+     */
+    bool pop(CO_IF_FRM* frame);
+
+    /**
+     * @return Overrun and high water counters
+     */
+    const Stats& getStats() const;
+
+    /**
+     * Fills in a CANopen stack CAN driver that reads from this queue and
+     * transmits on can
+     *
+     * @param[in] can CAN interface the stack transmits on
+     * @param[out] driver Driver to fill in
+     */
+    void getDriver(IO::CAN& can, CO_IF_CAN_DRV* driver);
+
+    /**
+     * Receive handler for CANDispatcher, pushing the frame
+     *
+     * @param[in] message The received frame
+     * @param[in] priv The queue
+     */
+    static void canHandler(IO::CANMessage& message, void* priv);
+
+private:
+    SPSCQueue<Frame, SIZE> queue;
+
+    /** Queue the driver reads from */
+    static CANopenQueue* driverQueue;
+    /** CAN interface the driver transmits on */
+    static IO::CAN* driverCAN;
+
+    static void driverInit();
+    static void driverEnable(uint32_t baudrate);
+    static int16_t driverSend(CO_IF_FRM* frame);
+    static int16_t driverRead(CO_IF_FRM* frame);
+    static void driverReset();
+    static void driverClose();
+};
+
+}// namespace PreCharge
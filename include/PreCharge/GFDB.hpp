@@ -3,6 +3,8 @@
 
 #include <EVT/io/CAN.hpp>
 #include <EVT/utils/time.hpp>
+#include <PreCharge/CANTxQueue.hpp>
+#include <PreCharge/utils/CycleStats.hpp>
 #include <stddef.h>
 
 namespace IO = EVT::core::IO;
@@ -28,6 +30,30 @@ enum GFDB_COMMAND {
     SET_MAX_VOLTAGE_CMD = 0xF0
 };
 
+/**
+ * Status of an asynchronous GFDB request
+ */
+enum class RequestStatus {
+    /** No request for the command is queued */
+    IDLE = 0,
+    /** The request is queued or waiting on a response */
+    PENDING = 1,
+    /** A response has been received */
+    READY = 2,
+    /** No response was received within the request timeout */
+    TIMEOUT = 3
+};
+
+/**
+ * Callback invoked when an asynchronous request completes
+ *
+ * @param[in] command Command the request was made with
+ * @param[in] status READY or TIMEOUT
+ * @param[in] payload Response payload with the echoed command byte removed, nullptr on timeout
+ * @param[in] priv Private data passed to queueRequest()
+ */
+typedef void (*ResponseCallback)(uint8_t command, RequestStatus status, const uint8_t* payload, void* priv);
+
 /**
  * SIM100 Driver for ground fault detection
  * https://sendyne.com/Datasheets/Sendyne%20SIM100MOD%20Datasheet%20V1.5.pdf
@@ -139,16 +165,161 @@ public:
      */
     IO::CAN::CANStatus setMaxBatteryVoltage(uint16_t maxVoltage);
 
+    /**
+     * Counters for the asynchronous request engine
+     */
+    struct RequestStats {
+        /** Requests transmitted */
+        uint32_t requests;
+        /** Responses matched to a request */
+        uint32_t responses;
+        /** Requests that timed out */
+        uint32_t timeouts;
+        /** Request to response time of the last response, in milliseconds */
+        uint32_t lastLatency;
+        /** Longest request to response time seen, in milliseconds */
+        uint32_t maxLatency;
+    };
+
+    /** Maximum number of asynchronous requests that can be outstanding */
+    static constexpr uint8_t MAX_PENDING_REQUESTS = 8;
+
+    /** Default time to wait for a response to an asynchronous request, in milliseconds */
+    static constexpr uint32_t DEFAULT_TIMEOUT = 100;
+
+    /** Number of response bytes following the echoed command byte */
+    static constexpr uint8_t RESPONSE_SIZE = 7;
+
+    /**
+     * Queues a request for the GFDB without waiting for the response. Only
+     * one request is on the bus at a time; the rest are transmitted in order
+     * by process(). A command that is already outstanding is not queued twice.
+     *
+     * If a callback is given it is run from process() once the request
+     * completes and the request is released. Otherwise the result is held
+     * until it is collected with pollResponse().
+     *
+     * @param[in] command Command to send to the GFDB
+     * @param[in] callback Function to call when the request completes, may be nullptr
+     * @param[in] priv Private data passed to the callback
+     * @param[in] timeout Time to wait for the response, in milliseconds
+     * @return OK if queued, ERROR if no request slot is free
+     */
+    IO::CAN::CANStatus queueRequest(uint8_t command, ResponseCallback callback = nullptr,
+                                    void* priv = nullptr, uint32_t timeout = DEFAULT_TIMEOUT);
+
+    /**
+     * Checks on an asynchronous request. A READY or TIMEOUT result releases
+     * the request, so it is only reported once.
+     *
+     * @param[in] command Command the request was made with
+     * @param[out] receiveBuff Buffer to store the response in when READY
+     * @param[in] receiveSize Size of receive buffer, at most RESPONSE_SIZE
+     * @return Status of the request
+     */
+    RequestStatus pollResponse(uint8_t command, uint8_t* receiveBuff, uint8_t receiveSize);
+
+    /**
+     * Drives the asynchronous requests: transmits the next queued request,
+     * expires requests that passed their timeout and runs callbacks. Must be
+     * called regularly from the main loop.
+     */
+    void process();
+
+    /**
+     * Matches a received CAN message against the outstanding request. Meant
+     * to be called from the CAN interrupt handler. A frame too short to hold
+     * the echoed command and RESPONSE_SIZE bytes is never matched, and the
+     * request times out instead.
+     *
+     * @param[in] message Received CAN message
+     * @return true if the message was the response to the outstanding request
+     */
+    bool handleCANMessage(IO::CANMessage& message);
+
+    /**
+     * @return Extended ID the GFDB responds on, for the CAN receive filter
+     */
+    uint32_t getResponseID() const;
+
+    /**
+     * Sends the asynchronous requests and sendCommand() through a transmit
+     * queue at DIAGNOSTIC priority instead of straight to the CAN interface.
+     * The blocking request functions keep transmitting directly, as they
+     * wait for their response before anything would drain the queue.
+     *
+     * @param[in] queue Queue to send through, nullptr to transmit directly
+     */
+    void setTxQueue(PreCharge::CANTxQueue* queue);
+
+    /**
+     * @return Counters for the asynchronous request engine
+     */
+    RequestStats getRequestStats() const;
+
+    /**
+     * @return Execution time of process(), callbacks included
+     */
+    const PreCharge::CycleStats& getProcessStats() const;
+
 private:
     IO::CAN& can;
+    /** Queue requests go out through, nullptr to transmit directly */
+    PreCharge::CANTxQueue* txQueue = nullptr;
     const uint32_t GFDB_ID = 0xA100101;
 
+    /**
+     * An asynchronous request slot
+     */
+    struct Request {
+        /** Command the request was made with */
+        uint8_t command;
+        /** Whether the request has been transmitted */
+        bool sent;
+        /** Status of the request, written from the CAN interrupt */
+        volatile RequestStatus status;
+        /** Response with the echoed command byte removed */
+        uint8_t payload[RESPONSE_SIZE];
+        /** Time the request was queued or transmitted, in milliseconds */
+        uint32_t startTime;
+        /** Time to wait for the response, in milliseconds */
+        uint32_t timeout;
+        /** Function to call on completion */
+        ResponseCallback callback;
+        /** Private data for the callback */
+        void* priv;
+    };
+
+    /** Request slots, a slot is free when its status is IDLE */
+    Request requests[MAX_PENDING_REQUESTS] = {};
+
+    /** Index of the request on the bus, MAX_PENDING_REQUESTS if none */
+    volatile uint8_t inFlight = MAX_PENDING_REQUESTS;
+
+    /** Slot to look for the next request to transmit from, so queued requests take turns */
+    uint8_t nextSlot = 0;
+
+    /** Counters for the asynchronous request engine */
+    RequestStats stats = {};
+
+    /** Execution time of process() */
+    PreCharge::CycleStats processStats = {};
+
+    /**
+     * Finds the slot holding an outstanding request
+     *
+     * @param[in] command Command the request was made with
+     * @return Index of the slot, MAX_PENDING_REQUESTS if not found
+     */
+    uint8_t findRequest(uint8_t command) const;
+
     /**
      * Helper method for requesting data from the GFDB through CAN
      *
      * @param[in] command Command to send to the GFDB
      * @param[out] receiveBuff Buffer to store data in
-     * @param[in] receiveSize Size of receive buffer
+     * @param[in] receiveSize Size of receive buffer, at most RESPONSE_SIZE
+     * bytes are filled in
      * @return The status of the CAN call
      */
     IO::CAN::CANStatus requestData(uint8_t command, uint8_t* receiveBuff, uint8_t receiveSize);
@@ -162,6 +333,14 @@ private:
      * @return The status of the CAN call
      */
     IO::CAN::CANStatus sendCommand(uint8_t command, uint8_t* payload, size_t payloadSize);
+
+    /**
+     * Queues a frame on txQueue, or transmits it when there is no queue
+     *
+     * @param[in] message Frame to send
+     * @return OK if the frame was queued or transmitted
+     */
+    IO::CAN::CANStatus send(IO::CANMessage& message);
 };
 
 }// namespace GFDB
@@ -0,0 +1,138 @@
+#ifndef _EVT_GFDB_POLLER_H
+#define _EVT_GFDB_POLLER_H
+
+#include <PreCharge/GFDB.hpp>
+#include <stdint.h>
+
+namespace GFDB {
+
+/**
+ * Keeps a cached snapshot of the SIM100 readings up to date. Each field is
+ * refreshed at its own rate through the GFDB's asynchronous requests, so
+ * readers get the latest value without any bus traffic.
+ */
+class GFDBPoller {
+public:
+    /**
+     * Readings kept in the snapshot
+     */
+    enum Field {
+        ISOLATION_STATE = 0,
+        ISOLATION_RESISTANCES,
+        ISOLATION_CAPACITANCES,
+        VOLTAGES_POSITIVE_NEGATIVE,
+        BATTERY_VOLTAGE,
+        TEMPERATURE,
+        ERROR_FLAGS,
+        NUM_FIELDS
+    };
+
+    /**
+     * Latest value of every field and when it was received
+     */
+    struct Snapshot {
+        /** Isolation state, bits 0-1 of the ISO_STATE response */
+        uint8_t isolationState;
+        /** Raw isolation resistances response */
+        uint8_t isolationResistances[GFDB::RESPONSE_SIZE];
+        /** Raw isolation capacitances response */
+        uint8_t isolationCapacitances[GFDB::RESPONSE_SIZE];
+        /** Positive voltage */
+        uint16_t voltageP;
+        /** Negative voltage */
+        uint16_t voltageN;
+        /** Battery voltage */
+        uint16_t batteryVoltage;
+        /** Temperature */
+        int32_t temperature;
+        /** Error flags */
+        uint8_t errorFlags;
+
+        /** Time each field was last received, in milliseconds */
+        uint32_t timestamp[NUM_FIELDS];
+        /** Bit per field, set once the field has been received */
+        uint8_t validMask;
+    };
+
+    /** Default refresh period of the isolation state, in milliseconds */
+    static constexpr uint32_t ISOLATION_STATE_PERIOD = 100;
+
+    /** Default refresh period of the other fields, in milliseconds */
+    static constexpr uint32_t DIAGNOSTIC_PERIOD = 1000;
+
+    /**
+     * Constructor for the GFDBPoller
+     *
+     * @param[in] gfdb GFDB to poll
+     */
+    GFDBPoller(GFDB& gfdb);
+
+    /**
+     * Sets how often a field is refreshed
+     *
+     * @param[in] field Field to configure
+     * @param[in] period Refresh period in milliseconds, 0 stops polling the field
+     */
+    void setPeriod(Field field, uint32_t period);
+
+    /**
+     * Queues every field that is due, in round-robin order, as long as the
+     * GFDB has request slots free. The requests are only sent and answered
+     * as GFDB::process() runs.
+     */
+    void refresh();
+
+    /**
+     * Queues the fields that are due and drives the GFDB's asynchronous
+     * requests. Must be called regularly from the main loop unless refresh()
+     * and GFDB::process() are run separately.
+     */
+    void process();
+
+    /**
+     * @return The latest snapshot
+     */
+    const Snapshot& getSnapshot() const;
+
+    /**
+     * Checks whether a field has been received recently enough to be trusted
+     *
+     * @param[in] field Field to check
+     * @param[in] maxAge Maximum age in milliseconds
+     * @return true if the field was received within maxAge
+     */
+    bool isFresh(Field field, uint32_t maxAge) const;
+
+private:
+    /** GFDB to poll */
+    GFDB& gfdb;
+
+    /** Latest readings */
+    Snapshot snapshot = {};
+
+    /** Refresh period of each field, in milliseconds */
+    uint32_t period[NUM_FIELDS];
+
+    /** Time each field was last requested, in milliseconds */
+    uint32_t lastRequest[NUM_FIELDS] = {};
+
+    /** Bit per field, set while its request is outstanding */
+    uint8_t pendingMask = 0;
+
+    /** Field the round-robin search starts from */
+    uint8_t nextField = 0;
+
+    /**
+     * Stores a completed request in the snapshot
+     *
+     * @param[in] command Command the request was made with
+     * @param[in] status READY or TIMEOUT
+     * @param[in] payload Response payload, nullptr on timeout
+     * @param[in] priv The GFDBPoller
+     */
+    static void responseCallback(uint8_t command, RequestStatus status, const uint8_t* payload, void* priv);
+};
+
+}// namespace GFDB
+
+#endif//_EVT_GFDB_POLLER_H
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <EVT/io/GPIO.hpp>
+#include <EVT/io/pin.hpp>
+
+#include <cstdint>
+
+namespace IO = EVT::core::IO;
+
+namespace PreCharge {
+
+/**
+ * Takes one snapshot of the state machine's GPIO per pass and debounces the
+ * inputs in it, all at once.
+ *
+ * On target each GPIO port with a pin of interest is read once, straight
+ * from its input data register, instead of going through readPin() for
+ * every pin. The host build reads the pins through readPin().
+ *
+ * Debounced inputs go through a vertical counter: one 2 bit counter per
+ * input, spread over two words, so every input is filtered with a handful of
+ * bitwise operations. An input has to read HIGH for DEBOUNCE_SAMPLES passes
+ * in a row before it reads HIGH in the snapshot, which takes
+ * (DEBOUNCE_SAMPLES - 1) times the pass period. LOW is taken at once,
+ * as every input filtered here is safe when LOW. Noise can only hold off
+ * enabling something, never hold off shutting it down.
+ */
+class InputSampler {
+public:
+    /** Maximum number of pins that can be sampled */
+    static constexpr uint8_t MAX_INPUTS = 8;
+    /** Passes a debounced input has to read HIGH before it is taken as HIGH */
+    static constexpr uint8_t DEBOUNCE_SAMPLES = 4;
+
+    /**
+     * How a pin is filtered
+     */
+    enum class Filter {
+        /** Passed through as read, for reading back outputs */
+        RAW = 0u,
+        /** HIGH only once it has been read DEBOUNCE_SAMPLES times in a row */
+        DEBOUNCE = 1u
+    };
+
+    /**
+     * Adds a pin to the snapshot
+     *
+     * @param[in] bit Bit of the snapshot the pin is reported in, below MAX_INPUTS
+     * @param[in] gpio The pin
+     * @param[in] pin Which pin gpio is, for reading its port directly
+     * @param[in] filter How the pin is filtered
+     */
+    void addInput(uint8_t bit, IO::GPIO& gpio, IO::Pin pin, Filter filter);
+
+    /**
+     * Reads every pin and updates the snapshot. Debounced inputs start out
+     * as read by the first call.
+     *
+     * @return The new snapshot, bit n HIGH for the pin added as bit n
+     */
+    uint32_t sample();
+
+    /**
+     * @return The snapshot taken by the last sample()
+     */
+    uint32_t getSnapshot() const;
+
+    /**
+     * @param[in] bit Bit the pin was added as
+     * @return The pin's level in the last snapshot
+     */
+    IO::GPIO::State get(uint8_t bit) const;
+
+private:
+    /** Number of GPIO ports a pin can be on, A to F */
+    static constexpr uint8_t NUM_PORTS = 6;
+
+    /** Pin added as each bit */
+    IO::GPIO* gpios[MAX_INPUTS] = {};
+    /** Port of each bit's pin, 0 for A */
+    uint8_t ports[MAX_INPUTS] = {};
+    /** Position of each bit's pin in its port */
+    uint8_t pins[MAX_INPUTS] = {};
+    /** Bits that have a pin */
+    uint32_t inputMask = 0;
+    /** Bits that are debounced */
+    uint32_t debounceMask = 0;
+    /** Ports with at least one pin, bit 0 for A */
+    uint8_t portMask = 0;
+
+    /** Current snapshot */
+    uint32_t snapshot = 0;
+    /** Low bit of each debounced input's counter */
+    uint32_t count0 = 0;
+    /** High bit of each debounced input's counter */
+    uint32_t count1 = 0;
+    /** Whether sample() has run */
+    bool primed = false;
+
+    /**
+     * Reads every pin
+     *
+     * @return Level of each pin, bit n for the pin added as bit n
+     */
+    uint32_t read();
+};
+
+}// namespace PreCharge
@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * Every message the PreCharge library logs through PreCharge::log::LOGGER,
+ * as X(name, level, format) entries.
+ *
+ * name becomes the log::MessageID, level is the EVT LogLevel the message is
+ * logged at and format is the printf format its arguments are rendered with,
+ * either by the text drain or by the host LogDecoder. All arguments are sent
+ * as 32 bit integers, so formats may only use %d, %u and %x.
+ *
+ * The ID of a message is its position in this list and is all that goes on
+ * the wire, so only ever append to it; a decoder must be built from the same
+ * list as the firmware it reads.
+ */
+#define PVC_LOG_MESSAGES(X)                                                                                       \
+    X(ESTOP_INTERRUPT, ERROR, "E-stop interrupt, outputs safe in %d ns")                                          \
+    X(GFDB_STALE, ERROR, "Stale GFDB")                                                                            \
+    X(GFDB_BAD, ERROR, "Bad GFDB")                                                                                \
+    X(STO_FAULT, ERROR, "Too many fails, error out")                                                              \
+    X(STO_INPUTS, ERROR, "1: %d, 2: %d, e: %d, g: %d")                                                            \
+    X(STATE_CHANGE, DEBUG, "s: %d, k: %d; sto: %d; b1: %d; b2: %d; e: %d; a: %d, pc: %d, dc: %d, c: %d, v: %d") \
+    X(PRECHARGE_SAMPLE, ERROR, "Meas: %d mV, Exp: %d mV, Pack: %d mV")                                          \
+    X(PRECHARGE_ERROR, DEBUG, "Precharge error")                                                                  \
+    X(PRECHARGE_DONE, DEBUG, "Precharge done")                                                                    \
+    X(TASK_MISSED, WARNING, "Task %d missed %d deadlines")                                                        \
+    X(PRECHARGE_EARLY_DONE, DEBUG, "Precharge done early, %d mV left at close, %d ms saved")                      \
+    X(DISCHARGE_DONE, DEBUG, "Discharged to %d mV in %d ms")                                                      \
+    X(ADC_STALLED, ERROR, "ADC sampler stalled, no sample for %d ms, %d SPI errors")
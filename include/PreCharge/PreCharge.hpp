@@ -8,8 +8,15 @@
 #include <EVT/io/UART.hpp>
 #include <EVT/io/pin.hpp>
 #include <PreCharge/GFDB.hpp>
+#include <PreCharge/GFDBPoller.hpp>
+#include <PreCharge/PreChargeCore.hpp>
+#include <PreCharge/PrechargeTrace.hpp>
+#include <PreCharge/RCCurve.hpp>
+#include <PreCharge/TauEstimator.hpp>
 #include <PreCharge/dev/Contactor.hpp>
 #include <PreCharge/dev/MAX22530.hpp>
+#include <PreCharge/dev/MAX22530Sampler.hpp>
+#include <PreCharge/utils/CycleStats.hpp>
 #include <co_core.h>
 
 #include <math.h>
@@ -19,100 +26,50 @@ namespace IO = EVT::core::IO;
 namespace PreCharge {
 
 /**
- * Represents the pre-charge controller used for DEV1
+ * Represents the pre-charge controller used for DEV1. Precharge follows the
+ * expected RC curve and any failure has to be cleared by cycling the key.
  */
-class PreCharge : public CANDevice {
+class PreCharge : public PreChargeCore<PreCharge> {
 public:
-    /**
-     * Binary representation of the states that the pre-charge controller can be in
-     */
-    enum class State {
-        // When the MC is powered off
-        MC_OFF = 0u,
-        // When the MC is powered on
-        MC_ON = 1u,
-        // When the MC is in emergency state
-        ESTOPWAIT = 2u,
-        // When the MC is precharging
-        PRECHARGE = 3u,
-        // When the MC is discharging
-        DISCHARGE = 4u,
-        // When the contactor is open
-        CONT_OPEN = 5u,
-        // When the contactor is closed
-        CONT_CLOSE = 6u,
-        // When the forward enable is disabled
-        FORWARD_DISABLE = 7u
-    };
-
-    /** PVC Pinout */
-    static constexpr IO::Pin UART_TX_PIN = IO::Pin::PB_6;
-    static constexpr IO::Pin UART_RX_PIN = IO::Pin::PB_7;
-    static constexpr IO::Pin CAN_TX_PIN = IO::Pin::PA_12;
-    static constexpr IO::Pin CAN_RX_PIN = IO::Pin::PA_11;
-    static constexpr IO::Pin KEY_IN_PIN = IO::Pin::PF_1;
-    static constexpr IO::Pin BAT_OK_1_PIN = IO::Pin::PB_5;
-    static constexpr IO::Pin BAT_OK_2_PIN = IO::Pin::PB_4;
-    static constexpr IO::Pin ESTOP_IN_PIN = IO::Pin::PF_0;
-    static constexpr IO::Pin PC_CTL_PIN = IO::Pin::PA_3;
-    static constexpr IO::Pin DC_CTL_PIN = IO::Pin::PA_4;
-    static constexpr IO::Pin APM_CTL_PIN = IO::Pin::PA_2;
-    static constexpr IO::Pin CONT1_PIN = IO::Pin::PA_10;
-    static constexpr IO::Pin CONT2_PIN = IO::Pin::PA_9;
-    static constexpr IO::Pin SPI_CS = IO::Pin::PB_0;
-    static constexpr IO::Pin SPI_MOSI = IO::Pin::PA_7;
-    static constexpr IO::Pin SPI_MISO = IO::Pin::PA_6;
-    static constexpr IO::Pin SPI_SCK = IO::Pin::PA_5;
-    static constexpr IO::Pin SPI_INT = IO::Pin::PA_8;
-
-    enum class PinStatus {
-        DISABLE = 0u,
-        ENABLE = 1u,
-        HOLD = 2u
-    };
-
-    enum class PrechargeStatus {
-        OK = 0u,
-        DONE = 1u,
-        ERROR = 2u
-    };
-
     enum class PVCStatus {
         PVC_OK = 0u,
         PVC_ERROR = 1u
     };
 
-    uint8_t Statusword;//8
-
-    uint64_t InputVoltage; //16
-    uint16_t OutputVoltage;//16
-    uint16_t BasePTemp;    //16
-
-    uint64_t changePDO;
-    uint64_t cyclicPDO;
-
-    static constexpr uint16_t DISCHARGE_DELAY = 5250;      // 5.25 seconds
-    static constexpr uint16_t FORWARD_DISABLE_DELAY = 5000;// 5 seconds
-
-    static constexpr uint8_t MIN_PACK_VOLTAGE = 70;
-
-    static constexpr uint8_t CONST_R = 30;
-    static constexpr float CONST_C = 0.014;
-
-    /**
-     * Number of attempts that will be made to check the STO status
-     * before failing
-     */
-    static constexpr uint16_t MAX_STO_ATTEMPTS = 25;
-
+    /** Allowed deviation from the expected precharge curve, in millivolts */
+    static constexpr int32_t PRECHARGE_TOLERANCE_MV = 5000;
+    /** Distance from the pack voltage at which precharge is done, in millivolts */
+    static constexpr int32_t PRECHARGE_DONE_MV = 1000;
     /**
-     * Utility variable which can be used to count the number of attempts that
-     * was made to complete a certain actions.
-     *
-     * For example, this is used for checking the STO N
-     * number of times before failing
+     * Default for the largest voltage allowed across the contactor when it
+     * closes, in millivolts. Matches what closing on PRECHARGE_DONE_MV
+     * already allows. Adjustable over SDO at 0x210E, 0 turns early closing off.
      */
-    uint16_t numAttemptsMade = 0;
+    static constexpr uint32_t PRECHARGE_INRUSH_MV = PRECHARGE_DONE_MV;
+
+    /** RC time constant of the precharge circuit in milliseconds */
+    static constexpr uint32_t PRECHARGE_TAU_MS = static_cast<uint32_t>(CONST_R * CONST_C * 1000 + 0.5f);
+
+    /** Expected precharge curve, generated at compile time */
+    using PrechargeCurve = RCCurve<PRECHARGE_TAU_MS>;
+
+    /** Fits the actual time constant at the start of each precharge */
+    using PrechargeTauEstimator = TauEstimator<PrechargeCurve>;
+
+    /** Failures latch until the key is cycled */
+    static constexpr bool LATCH_KEY_CYCLE = true;
+    /** Turning the key with the e-stop held resets the BMS */
+    static constexpr bool BMS_RESET_ON_ESTOP = true;
+    /** Frame waking the TMS once the contactor is closed */
+    static constexpr uint8_t TMS_WAKE_PAYLOAD[] = {0x01, 0x08};
+    /** Frame sending the TMS back to pre-op once the APM is off */
+    static constexpr uint8_t TMS_PRE_OP_PAYLOAD[] = {0x80, 0x08};
+    /** The change PDO carries every field of changePDO */
+    static constexpr uint64_t CHANGE_PDO_FIELDS = ~0ull;
+    /** Byte 0 of the change PDO is the current state */
+    static constexpr bool CHANGE_PDO_PASS_STATE = false;
+    /** RPDO0 brings in the motor controller status, so the filter accepts it */
+    static constexpr bool HAS_RPDO0 = true;
 
     /**
      * Constructor for pre-charge state machine
@@ -130,14 +87,9 @@ public:
      * @param[in] can can instance for CANopen
      */
     PreCharge(IO::GPIO& key, IO::GPIO& batteryOne, IO::GPIO& batteryTwo,
-              IO::GPIO& eStop, IO::GPIO& pc, IO::GPIO& dc, Contactor cont,
+              IO::GPIO& eStop, IO::GPIO& pc, IO::GPIO& dc, Contactor& cont,
               IO::GPIO& apm, GFDB::GFDB& gfdb, IO::CAN& can, MAX22530 MAX);
 
-    /**
-     * The node ID used to identify the device on the CAN network.
-     */
-    static constexpr uint8_t NODE_ID = 10;
-
     /**
      * Handler running the pre-charge state switching
      *
@@ -146,14 +98,28 @@ public:
     PVCStatus handle();
 
     /**
-     * Get the value of STO (Safe to Operate)
-     *
-     * TODO: Update documentation
-     * STO=1 when BATTERY_1_OK=1 AND BATTERY_2_OK=1 AND EMERGENCY_STOP=1
+     * Safety inputs and state machine half of handle(): updates STO, the key
+     * and the IO status and steps the current state. Meant to be run as a
+     * high rate scheduler task, with handleADC() and handleGFDB() at their
+     * own rates.
      *
-     * @return value of STO, 0 or 1
+     * @return the current status of the PVC, either PVC_OK or PVC_Error
+     */
+    PVCStatus handleSafety();
+
+    /**
+     * Brings the ADC sample the state machine works from up to date
      */
-    void getSTO();
+    void handleADC();
+
+    /**
+     * Queues the GFDB readings that are due. The requests are only carried
+     * out as GFDB::process() runs, which should happen as often as possible.
+     * A field is refreshed no more often than this runs, so its task period
+     * must not be longer than the shortest poller period,
+     * GFDBPoller::ISOLATION_STATE_PERIOD by default.
+     */
+    void handleGFDB();
 
     /**
      * Get the value of the Precharge compared against the ideal precharge voltage curve
@@ -167,171 +133,148 @@ public:
     int getPrechargeStatus();
 
     /**
-     * Requests and handles the isolation state from the SIM100
-    */
-    void checkGFDB();
-
-    /**
-     * Get the current expected voltage based on the current precharge time
+     * Get the sampler that can feed the ADC readings from interrupt context.
+     * Once it is started, handle() works from the queued samples instead of
+     * reading the ADC itself.
      *
-     * @return float value of expected voltage in Volts
-    */
-    uint16_t solveForVoltage(uint16_t pack_voltage, uint64_t delta_time);
-
-    /**
-     * Get the state of MC_KEY_IN
-     *
-     */
-    void getMCKey();
-
-    /**
-     * Get the state of all IO instances and update IOStatus
+     * @return The ADC sampler
      */
-    void getIOStatus();
+    MAX22530Sampler& getSampler();
 
     /**
-     * Set the Precharge state
+     * Get the recorded voltage curves of the last precharge attempts, also
+     * readable over SDO at 0x210C
      *
-     * @param state 0 = precharge disabled, 1 = precharge enabled
+     * @return The precharge trace
      */
-    void setPrecharge(PinStatus state);
+    const PrechargeTrace& getTrace() const;
 
     /**
-     * Set the Discharge state
+     * Get the estimator of the precharge time constant, whose estimate
+     * solveForVoltage() follows
      *
-     * @param state 0 = discharge disabled, 1 = discharge enabled
+     * @return The time constant estimator
      */
-    void setDischarge(PinStatus state);
+    const PrechargeTauEstimator& getTauEstimator() const;
 
     /**
-     * Set the APM state
+     * Get the current expected voltage based on the current precharge time,
+     * following the time constant fitted by the tau estimator
      *
-     * @param state 0 = APM disabled, 1 = APM enabled
-     */
-    void setAPM(PinStatus state);
+     * @param[in] pack_voltage Pack voltage being charged towards, in millivolts
+     * @param[in] delta_time Time since precharge started in milliseconds
+     * @return expected voltage in millivolts
+    */
+    int32_t solveForVoltage(int32_t pack_voltage, uint64_t delta_time);
 
     /**
-     * Handles when the MC is powered off.
+     * Handles when precharge is to occur.
      *
-     * State: State::MC_OFF
+     * State: State::PRECHARGE
      */
-    void mcOffState();
+    void prechargeState();
 
-    /**
-     * Handles when the MC is powered on.
-     *
-     * State: State::MC_ON
-     */
-    void mcOnState();
+    /** Handler of each State, in State order */
+    static constexpr StateHandler STATE_HANDLERS[NUM_STATES] = {
+        &PreCharge::mcOffState,
+        &PreCharge::mcOnState,
+        &PreCharge::eStopState,
+        &PreCharge::prechargeState,
+        &PreCharge::dischargeState,
+        &PreCharge::contOpenState,
+        &PreCharge::contCloseState,
+        &PreCharge::forwardDisableState,
+    };
 
-    /**
-     * Handles when an unsafe condition is detected while the MC is off.
-     *
-     * State: State::ESTOPWAIT
-     */
-    void eStopState();
+    CO_OBJ_T* getObjectDictionary() override;
+
+    uint8_t getNumElements() override;
 
+    uint8_t getNodeID() override;
+
+private:
+    /** Samples the ADC from interrupt context when started */
+    MAX22530Sampler sampler;
     /**
-     * Handles when precharge is to occur.
-     *
-     * State: State::PRECHARGE
+     * Result of the samples checked against the precharge curve so far.
+     * Latches at the first DONE or ERROR, which may come from a queued
+     * sample between ticks.
      */
-    void prechargeState();
-
+    PrechargeStatus prechargeSampleStatus = PrechargeStatus::OK;
+    /** Whether adcSample has already been checked against the precharge curve */
+    bool prechargeSampleChecked = false;
+
+    /** Output voltage when precharge started, in millivolts */
+    int32_t initVolt;
+
+    /** Curves of the last precharge attempts */
+    PrechargeTrace trace;
+
+    /** Fits the precharge time constant */
+    PrechargeTauEstimator tauEstimator;
+    /** Estimated precharge time constant in milliseconds, for the object dictionary */
+    uint32_t estimatedTau = PRECHARGE_TAU_MS;
+    /** Estimated capacitance being precharged in microfarads, for the object dictionary */
+    uint32_t estimatedCapacitance = PRECHARGE_TAU_MS * 1000 / CONST_R;
+
+    /** Largest predicted voltage across the contactor as it closes, in millivolts, 0 to wait for the done window */
+    uint32_t inrushLimit = PRECHARGE_INRUSH_MV;
+    /** Voltage across the contactor predicted for the running precharge, in millivolts */
+    int32_t predictedInrush = 0;
+    /** Time saved by the running precharge closing early, in milliseconds */
+    uint32_t prechargeTimeSaved = 0;
+    /** Time saved by the last precharge closing early, in milliseconds */
+    uint32_t lastTimeSaved = 0;
+    /** Time saved by all precharges closing early, in milliseconds */
+    uint32_t totalTimeSaved = 0;
+
+    /** ADC channels used by the state machine, output and pack voltage */
+    static constexpr uint8_t ADC_CHANNELS = MAX22530::channelMask(0x01) | MAX22530::channelMask(0x02);
     /**
-     * Handles when discharge is to occur.
-     *
-     * State: State::DISCHARGE
+     * Oldest the sampler's last sample may be, in milliseconds, five periods
+     * at its fastest rate. Past it the sampler is taken as stalled.
      */
-    void dischargeState();
+    static constexpr uint32_t ADC_MAX_AGE = 5 * 1000 / MAX22530Sampler::MAX_RATE;
 
     /**
-     * Handles when the contactor is to be open.
+     * Brings adcSample up to date, either by reading the ADC or by draining
+     * the sampler. While precharging, every drained sample is checked against
+     * the curve once, so a fault or the done window between ticks is caught,
+     * and the first DONE or ERROR latches into prechargeSampleStatus.
      *
-     * State: State::CONT_OPEN
+     * A sampler that has not delivered a sample within ADC_MAX_AGE, from a
+     * stalled timer or failing SPI reads, is stopped and logged, and the ADC
+     * is read directly from then on. adcSampleTime only moves on a
+     * successful read, so a failing direct read leaves the sample visibly
+     * old.
      */
-    void contOpenState();
+    void updateSamples();
 
     /**
-     * Handles when the contactor is to be closed.
+     * Checks whether the contactor can close before the output reaches the
+     * done window. The fitted curve gives the voltage still across the
+     * contactor once its close pulse has run, which has to be within
+     * inrushLimit.
      *
-     * State: State::CONT_CLOSE
+     * @param[in] measured_voltage Output voltage, in millivolts
+     * @param[in] pack_voltage Pack voltage, in millivolts
+     * @return true if the contactor can close now
      */
-    void contCloseState();
+    bool canCloseEarly(int32_t measured_voltage, int32_t pack_voltage);
 
     /**
-     * Handles when the Forward Enable is to be disabled.
+     * Compares adcSample against the ideal precharge voltage curve
      *
-     * State: State::FORWARD_DISABLE
+     * @param[in] delta_time Time since precharge started when the sample was taken, in milliseconds
+     * @return DONE, OK or ERROR for the sample
      */
-    void forwardDisableState();
-
-    CO_OBJ_T* getObjectDictionary() override;
-
-    uint8_t getNumElements() override;
-
-    uint8_t getNodeID() override;
-
-private:
-    /** GPIO instance to monitor KEY_IN */
-    IO::GPIO& key;
-    /** GPIO instance to monitor BATTERY_1_OK */
-    IO::GPIO& batteryOne;
-    /** GPIO instance to monitor BATTERY_2_OK */
-    IO::GPIO& batteryTwo;
-    /** GPIO instance to monitor ESTOP_STATUS */
-    IO::GPIO& eStop;
-    /** GPIO instance to toggle PC_CTL */
-    IO::GPIO& pc;
-    /** GPIO instance to toggle DC_CTL */
-    IO::GPIO& dc;
-    /** Contactor instance to control the main contactor */
-    Contactor cont;
-    /** GPIO instance to toggle APM_CTL */
-    IO::GPIO& apm;
-    /** GPIO instance to toggle FW_EN_CTL */
-    //    IO::GPIO& forward;
-    /** GFDB instance to handle isolation status*/
-    GFDB::GFDB& gfdb;
-    /** CAN instance to handle CANOpen processes*/
-    IO::CAN& can;
-
-    MAX22530 MAX;
-
-    IO::GPIO::State keyInStatus;
-    IO::GPIO::State stoStatus;
-    IO::GPIO::State batteryOneOkStatus;
-    IO::GPIO::State batteryTwoOkStatus;
-    IO::GPIO::State eStopActiveStatus;
-    IO::GPIO::State pcStatus;
-    IO::GPIO::State dcStatus;
-    uint8_t contStatus;
-    uint8_t voltStatus;
-    IO::GPIO::State apmStatus;
-
-    uint8_t gfdStatus;
-    uint32_t lastPrechargeTime;
-
-    // Status bit to indicate a precharge error
-    // Key must be cycled (on->off->on) to resume state machine
-    uint8_t cycle_key;
-
-    State state;
-    State prevState;
-    uint64_t state_start_time;
-    int in_precharge;
-    uint8_t initVolt;
-
-    /**
-     * Handles the sending of a CAN message upon each state change.
-    */
-    void sendChangePDO();
+    PrechargeStatus checkPrechargeSample(uint64_t delta_time);
 
     /**
      * Have to know the size of the object dictionary for initialization
      * process.
      */
-    static constexpr uint8_t OBJECT_DICTIONARY_SIZE = 22;
+    static constexpr uint8_t OBJECT_DICTIONARY_SIZE = 138;
 
     /**
      * The object dictionary itself. Will be populated by this object during
@@ -346,6 +289,19 @@ private:
         IDENTITY_OBJECT_1018,
         SDO_CONFIGURATION_1200,
 
+        // RPDO0 settings, the motor controller status confirming forward
+        // disable. The motor controller sends it on this node's default
+        // RPDO0 COB-ID, 0x200 plus the node ID, as soon as it changes. The
+        // COB-ID is read only, as the CAN receive filter only accepts the
+        // default one (see PreChargeCore's constructor).
+        {CO_KEY(0x1400, 0, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (0x02)},
+        {CO_KEY(0x1400, 1, CO_OBJ_DN__R_), CO_TUNSIGNED32, (CO_DATA) (0x200)},
+        {CO_KEY(0x1400, 2, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (RECEIVE_PDO_TRIGGER_ASYNC)},
+
+        // RPDO0 mapping, the 16 bit status goes to 0x2110 sub-index 1
+        {CO_KEY(0x1600, 0, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (0x01)},
+        {CO_KEY(0x1600, 1, CO_OBJ_D___R_), CO_TUNSIGNED32, (CO_DATA) (CO_LINK(0x2110, 0x01, PDO_MAPPING_UNSIGNED16))},
+
         // TPDO0 settings
         // 0: The TPDO number, default 0
         // 1: The COB-ID used by TPDO0, provided as a function of the TPDO number
@@ -368,6 +324,113 @@ private:
         DATA_LINK_START_KEY_21XX(0, 0x01),
         DATA_LINK_21XX(0x00, 0x01, CO_TUNSIGNED8, &state),
 
+        // Execution time profile, read only over SDO. Sub-index 1 to 4 hold
+        // the calls, min, max and average in CycleCounter ticks.
+        // 0x2101 - 0x2108: Each state's handler, in State order
+        // 0x2109: getSTO()
+        // 0x210A: GFDB::process()
+        // 0x210B: MAX22530::readChannels()
+        CYCLE_STATS_LINK_21XX(0x01, stateStats[0]),
+        CYCLE_STATS_LINK_21XX(0x02, stateStats[1]),
+        CYCLE_STATS_LINK_21XX(0x03, stateStats[2]),
+        CYCLE_STATS_LINK_21XX(0x04, stateStats[3]),
+        CYCLE_STATS_LINK_21XX(0x05, stateStats[4]),
+        CYCLE_STATS_LINK_21XX(0x06, stateStats[5]),
+        CYCLE_STATS_LINK_21XX(0x07, stateStats[6]),
+        CYCLE_STATS_LINK_21XX(0x08, stateStats[7]),
+        CYCLE_STATS_LINK_21XX(0x09, stoStats),
+        CYCLE_STATS_LINK_21XX(0x0A, gfdb.getProcessStats()),
+        CYCLE_STATS_LINK_21XX(0x0B, MAX.getReadStats()),
+
+        // Voltage curves of the last precharge attempts, one domain per
+        // attempt laid out as PrechargeTrace::Attempt. Read only over SDO.
+        {CO_KEY(0x210C, 0, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (PrechargeTrace::NUM_ATTEMPTS)},
+        {CO_KEY(0x210C, 1, CO_OBJ_____R_), CO_TDOMAIN, (CO_DATA) (trace.getDomain(0))},
+        {CO_KEY(0x210C, 2, CO_OBJ_____R_), CO_TDOMAIN, (CO_DATA) (trace.getDomain(1))},
+        {CO_KEY(0x210C, 3, CO_OBJ_____R_), CO_TDOMAIN, (CO_DATA) (trace.getDomain(2))},
+        {CO_KEY(0x210C, 4, CO_OBJ_____R_), CO_TDOMAIN, (CO_DATA) (trace.getDomain(3))},
+
+        // Precharge circuit as fitted by the last precharge, read only
+        // 1: Capacitance in microfarads
+        // 2: Time constant in milliseconds
+        {CO_KEY(0x210D, 0, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (0x02)},
+        {CO_KEY(0x210D, 1, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&estimatedCapacitance)},
+        {CO_KEY(0x210D, 2, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&estimatedTau)},
+
+        // Closing the contactor before precharge reaches the done window
+        // 1: Inrush limit in millivolts, 0 to turn early closing off
+        // 2: Time saved by the last precharge in milliseconds, read only
+        // 3: Time saved by all precharges in milliseconds, read only
+        DATA_LINK_START_KEY_21XX(0x0E, 0x03),
+        DATA_LINK_21XX(0x0E, 0x01, CO_TUNSIGNED32, &inrushLimit),
+        {CO_KEY(0x210E, 2, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&lastTimeSaved)},
+        {CO_KEY(0x210E, 3, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&totalTimeSaved)},
+
+        // Discharge
+        // 1: Safe output voltage in millivolts
+        // 2-5: Discharges completed, timed out, last and longest duration
+        // in milliseconds, read only
+        DATA_LINK_START_KEY_21XX(0x0F, 0x05),
+        DATA_LINK_21XX(0x0F, 0x01, CO_TUNSIGNED32, &dischargeSafeMillivolts),
+        {CO_KEY(0x210F, 2, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&dischargeStats.count)},
+        {CO_KEY(0x210F, 3, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&dischargeStats.timeouts)},
+        {CO_KEY(0x210F, 4, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&dischargeStats.lastDuration)},
+        {CO_KEY(0x210F, 5, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&dischargeStats.maxDuration)},
+
+        // Forward disable, ended early by the motor controller status
+        // 1: Motor controller status, written by RPDO0
+        // 2: Status bits checked, 0 to always wait FORWARD_DISABLE_DELAY
+        // 3: Value of the checked bits once the motor controller is disabled
+        // 4-7: Forward disables completed, not confirmed, last and longest
+        // duration in milliseconds, read only
+        DATA_LINK_START_KEY_21XX(0x10, 0x07),
+        DATA_LINK_21XX(0x10, 0x01, CO_TUNSIGNED16, &mcStatus),
+        DATA_LINK_21XX(0x10, 0x02, CO_TUNSIGNED16, &mcDisabledMask),
+        DATA_LINK_21XX(0x10, 0x03, CO_TUNSIGNED16, &mcDisabledValue),
+        {CO_KEY(0x2110, 4, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&forwardDisableStats.count)},
+        {CO_KEY(0x2110, 5, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&forwardDisableStats.timeouts)},
+        {CO_KEY(0x2110, 6, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&forwardDisableStats.lastDuration)},
+        {CO_KEY(0x2110, 7, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&forwardDisableStats.maxDuration)},
+
+        // Change PDO, split into 32 bit halves, low half first
+        // 1-2: Status word as last packed, read only
+        // 3-4: Bits of the status word that send a change PDO when they change
+        {CO_KEY(0x2111, 0, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (0x04)},
+        {CO_KEY(0x2111, 1, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (reinterpret_cast<uint32_t*>(&changePDO))},
+        {CO_KEY(0x2111, 2, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (reinterpret_cast<uint32_t*>(&changePDO) + 1)},
+        DATA_LINK_21XX(0x11, 0x03, CO_TUNSIGNED32, reinterpret_cast<uint32_t*>(&changePDOTrigger)),
+        DATA_LINK_21XX(0x11, 0x04, CO_TUNSIGNED32, reinterpret_cast<uint32_t*>(&changePDOTrigger) + 1),
+
+        // Transmit queue, read only
+        // 0x2112: Enqueue to transmit latency, as the execution time profile
+        // 0x2113: Frames pending, most pending, sent, dropped and coalesced
+        CYCLE_STATS_LINK_21XX(0x12, txQueue.getLatencyStats()),
+        {CO_KEY(0x2113, 0, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (0x05)},
+        {CO_KEY(0x2113, 1, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&txQueue.getStats().depth)},
+        {CO_KEY(0x2113, 2, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&txQueue.getStats().maxDepth)},
+        {CO_KEY(0x2113, 3, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&txQueue.getStats().sent)},
+        {CO_KEY(0x2113, 4, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&txQueue.getStats().dropped)},
+        {CO_KEY(0x2113, 5, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&txQueue.getStats().coalesced)},
+
+        // Receive filter, read only
+        // 0x2114: Frames received, standard accepted, extended accepted and rejected
+        // 0x2115: Time spent filtering and handling each frame in the interrupt
+        {CO_KEY(0x2114, 0, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (0x04)},
+        {CO_KEY(0x2114, 1, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&canDispatcher.getStats().received)},
+        {CO_KEY(0x2114, 2, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&canDispatcher.getStats().standard)},
+        {CO_KEY(0x2114, 3, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&canDispatcher.getStats().extended)},
+        {CO_KEY(0x2114, 4, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&canDispatcher.getStats().rejected)},
+        CYCLE_STATS_LINK_21XX(0x15, canDispatcher.getDispatchStats()),
+
+        // CANopen receive queue, read only
+        // 1: Frames the queue holds
+        // 2: Most frames it has held at once
+        // 3: Frames dropped as it was full
+        {CO_KEY(0x2116, 0, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (0x03)},
+        {CO_KEY(0x2116, 1, CO_OBJ_D___R_), CO_TUNSIGNED32, (CO_DATA) (CANopenQueue::SIZE)},
+        {CO_KEY(0x2116, 2, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&canOpenQueue.getStats().highWater)},
+        {CO_KEY(0x2116, 3, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&canOpenQueue.getStats().overruns)},
+
         // End of dictionary marker
         CO_OBJ_DICT_ENDMARK,
     };
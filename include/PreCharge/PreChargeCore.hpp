@@ -0,0 +1,663 @@
+#pragma once
+
+#include <EVT/io/CAN.hpp>
+#include <EVT/io/CANDevice.hpp>
+#include <EVT/io/GPIO.hpp>
+#include <EVT/io/pin.hpp>
+#include <PreCharge/CANDispatcher.hpp>
+#include <PreCharge/CANTxQueue.hpp>
+#include <PreCharge/CANopenQueue.hpp>
+#include <PreCharge/GFDB.hpp>
+#include <PreCharge/GFDBPoller.hpp>
+#include <PreCharge/InputSampler.hpp>
+#include <PreCharge/dev/Contactor.hpp>
+#include <PreCharge/dev/MAX22530.hpp>
+#include <PreCharge/utils/CycleCounter.hpp>
+#include <PreCharge/utils/CycleStats.hpp>
+
+#include <cstdint>
+
+namespace IO = EVT::core::IO;
+
+namespace PreCharge {
+
+/**
+ * Binary representation of the states that the pre-charge controller can be
+ * in, shared by every vehicle variant
+ */
+enum class State {
+    // When the MC is powered off
+    MC_OFF = 0u,
+    // When the MC is powered on
+    MC_ON = 1u,
+    // When the MC is in emergency state
+    ESTOPWAIT = 2u,
+    // When the MC is precharging
+    PRECHARGE = 3u,
+    // When the MC is discharging
+    DISCHARGE = 4u,
+    // When the contactor is open
+    CONT_OPEN = 5u,
+    // When the contactor is closed
+    CONT_CLOSE = 6u,
+    // When the forward enable is disabled
+    FORWARD_DISABLE = 7u
+};
+
+/**
+ * State machine shared by the pre-charge controller variants.
+ *
+ * A variant derives from PreChargeCore<Variant> and supplies at compile time:
+ *  - STATE_HANDLERS, its transition table: the handler called for each
+ *    State, or nullptr for a state the variant just holds in
+ *  - LATCH_KEY_CYCLE, whether a failed STO or a pressed e-stop requires the
+ *    key to be cycled before the state machine leaves MC_OFF again
+ *  - BMS_RESET_ON_ESTOP, whether turning the key while the e-stop is held
+ *    sends the BMS reset frames
+ *  - TMS_WAKE_PAYLOAD and TMS_PRE_OP_PAYLOAD, the frames waking the TMS when
+ *    the MC comes on and sending it back to pre-op when it goes off
+ *  - CHANGE_PDO_FIELDS and CHANGE_PDO_PASS_STATE, its change PDO layout: the
+ *    bits of changePDO the payload carries, and whether byte 0 is the state
+ *    the pass started in (Statusword) instead of the current state
+ *  - HAS_RPDO0, whether its object dictionary has RPDO0 at 0x1400 and
+ *    0x1600, so the receive filter accepts RPDO0's COB-ID
+ *
+ * Handlers are called through the table without any virtual dispatch, so a
+ * variant only pays for the states and policies it uses. The handlers for
+ * the states that behave the same on every vehicle live here. The variant
+ * still provides the CANDevice object dictionary.
+ *
+ * @tparam Variant The derived pre-charge controller
+ */
+template<typename Variant>
+class PreChargeCore : public CANDevice {
+public:
+    using State = ::PreCharge::State;
+
+    /** State handler as listed in the transition table of a variant */
+    using StateHandler = void (Variant::*)();
+
+    /** Number of entries in State, and so in a transition table */
+    static constexpr uint8_t NUM_STATES = 8;
+
+    /** PVC Pinout */
+    static constexpr IO::Pin UART_TX_PIN = IO::Pin::PB_6;
+    static constexpr IO::Pin UART_RX_PIN = IO::Pin::PB_7;
+    static constexpr IO::Pin CAN_TX_PIN = IO::Pin::PA_12;
+    static constexpr IO::Pin CAN_RX_PIN = IO::Pin::PA_11;
+    static constexpr IO::Pin KEY_IN_PIN = IO::Pin::PF_1;
+    static constexpr IO::Pin BAT_OK_1_PIN = IO::Pin::PB_5;
+    static constexpr IO::Pin BAT_OK_2_PIN = IO::Pin::PB_4;
+    static constexpr IO::Pin ESTOP_IN_PIN = IO::Pin::PF_0;
+    static constexpr IO::Pin PC_CTL_PIN = IO::Pin::PA_3;
+    static constexpr IO::Pin DC_CTL_PIN = IO::Pin::PA_4;
+    static constexpr IO::Pin APM_CTL_PIN = IO::Pin::PA_2;
+    static constexpr IO::Pin CONT1_PIN = IO::Pin::PA_10;
+    static constexpr IO::Pin CONT2_PIN = IO::Pin::PA_9;
+    static constexpr IO::Pin SPI_CS = IO::Pin::PB_0;
+    static constexpr IO::Pin SPI_MOSI = IO::Pin::PA_7;
+    static constexpr IO::Pin SPI_MISO = IO::Pin::PA_6;
+    static constexpr IO::Pin SPI_SCK = IO::Pin::PA_5;
+    static constexpr IO::Pin SPI_INT = IO::Pin::PA_8;
+
+    /**
+     * Bits of the IO snapshot taken at the start of each pass
+     */
+    enum InputBit : uint8_t {
+        INPUT_KEY = 0,
+        INPUT_BATTERY_ONE = 1,
+        INPUT_BATTERY_TWO = 2,
+        INPUT_ESTOP = 3,
+        INPUT_PC = 4,
+        INPUT_DC = 5,
+        INPUT_APM = 6,
+    };
+
+    enum class PinStatus {
+        DISABLE = 0u,
+        ENABLE = 1u,
+        HOLD = 2u
+    };
+
+    enum class PrechargeStatus {
+        OK = 0u,
+        DONE = 1u,
+        ERROR = 2u
+    };
+
+    /**
+     * Counters kept by the e-stop interrupt
+     */
+    struct EStopStats {
+        /** Number of e-stop interrupts taken */
+        uint32_t count;
+        /** Time from entering the handler until the last output was driven safe, in nanoseconds */
+        uint32_t lastLatency;
+        /** Longest lastLatency seen, in nanoseconds */
+        uint32_t maxLatency;
+    };
+
+    /**
+     * Counters of a state that waits for a condition, bounded by a timeout
+     */
+    struct WaitStats {
+        /** Number of waits completed */
+        uint32_t count;
+        /** Waits that ran to the timeout without the condition being met */
+        uint32_t timeouts;
+        /** Duration of the last wait, in milliseconds */
+        uint32_t lastDuration;
+        /** Longest lastDuration seen, in milliseconds */
+        uint32_t maxDuration;
+
+        /**
+         * Counts a completed wait
+         *
+         * @param[in] duration Time spent waiting, in milliseconds
+         * @param[in] timedOut Whether the wait ended on its timeout
+         */
+        void record(uint32_t duration, bool timedOut) {
+            count++;
+            timeouts += timedOut ? 1 : 0;
+            lastDuration = duration;
+            if (duration > maxDuration) {
+                maxDuration = duration;
+            }
+        }
+    };
+
+    /** State the current pass started in */
+    uint8_t Statusword;//8
+
+    uint64_t InputVoltage; //16
+    uint16_t OutputVoltage;//16
+    uint16_t BasePTemp;    //16
+
+    /**
+     * Bit offsets of the fields packed into changePDO. Each byte of the word
+     * is the byte of the change PDO payload at the same position, little
+     * endian, so the payload is a straight copy of the word.
+     */
+    enum StatusBit : uint8_t {
+        STATUS_STATE = 0,
+        STATUS_STO = 16,
+        STATUS_KEY = 20,
+        STATUS_BATTERY_TWO = 24,
+        STATUS_BATTERY_ONE = 28,
+        STATUS_APM = 32,
+        STATUS_ESTOP = 36,
+        STATUS_DC = 40,
+        STATUS_PC = 44,
+        STATUS_VOLT = 48,
+        STATUS_CONT = 52,
+    };
+
+    /** Bits of each IO status field in changePDO, all but the state */
+    static constexpr uint64_t STATUS_FIELD_MASK = 0xF;
+
+    /** Fields of changePDO that all have to be set for STO to be HIGH, besides the GFDB */
+    static constexpr uint64_t STO_INPUTS = 1ull << STATUS_BATTERY_ONE | 1ull << STATUS_BATTERY_TWO
+                                           | 1ull << STATUS_ESTOP | 1ull << STATUS_VOLT;
+
+    /** Number of bytes of changePDO sent in the change PDO */
+    static constexpr uint8_t CHANGE_PDO_SIZE = 7;
+
+    /**
+     * Default bits of changePDO that send a change PDO when they change, the
+     * state. Adjustable over SDO at 0x2111, to report input changes as well.
+     */
+    static constexpr uint64_t CHANGE_PDO_TRIGGER = 0xFFull << STATUS_STATE;
+
+    /**
+     * State and IO status packed at the StatusBit offsets. The IO status
+     * fields are only kept here, set where the inputs are read and the
+     * outputs driven. The state is copied in at the end of each pass.
+     */
+    uint64_t changePDO;
+    uint64_t cyclicPDO;
+
+    static constexpr uint16_t DISCHARGE_DELAY = 5250;      // 5.25 seconds, discharge timeout
+    static constexpr uint16_t FORWARD_DISABLE_DELAY = 5000;// 5 seconds, forward disable timeout
+
+    /**
+     * Default output voltage below which discharge is complete, in
+     * millivolts. Well under the 60 V touch safe limit.
+     */
+    static constexpr uint32_t DISCHARGE_SAFE_MILLIVOLTS = 10000;
+    /** Time the output has to stay below the safe voltage to end discharge, in milliseconds */
+    static constexpr uint32_t DISCHARGE_DEBOUNCE = 100;
+
+    /**
+     * Default bits of the motor controller status that are compared to
+     * MC_DISABLED_VALUE to confirm it is disabled. 0 turns confirmation off,
+     * leaving forward disable to run to FORWARD_DISABLE_DELAY.
+     */
+    static constexpr uint16_t MC_DISABLED_MASK = 0xFFFF;
+    /** Default masked motor controller status of a disabled controller, no current */
+    static constexpr uint16_t MC_DISABLED_VALUE = 0;
+
+    static constexpr uint8_t MIN_PACK_VOLTAGE = 70;
+    static constexpr int32_t MIN_PACK_MILLIVOLTS = MIN_PACK_VOLTAGE * 1000;
+
+    static constexpr uint8_t CONST_R = 30;
+    static constexpr float CONST_C = 0.014;
+
+    /**
+     * Number of attempts that will be made to check the STO status
+     * before failing
+     */
+    static constexpr uint16_t MAX_STO_ATTEMPTS = 25;
+
+    /**
+     * Minimum time between counted STO attempts in milliseconds, so the
+     * tolerance window does not shrink when getSTO() runs more often
+     */
+    static constexpr uint32_t STO_ATTEMPT_PERIOD = 100;
+
+    /** Minimum time between BMS reset bursts while the e-stop is held, in milliseconds */
+    static constexpr uint32_t BMS_RESET_PERIOD = 100;
+
+    /**
+     * Oldest isolation state sample, in milliseconds, that getSTO() will
+     * trust before treating the GFDB as faulted. The isolation state is
+     * polled every GFDBPoller::ISOLATION_STATE_PERIOD, so this allows for
+     * a couple of seconds of lost or unanswered requests.
+     */
+    static constexpr uint32_t GFDB_MAX_AGE = 2500;
+
+    /**
+     * The node ID used to identify the device on the CAN network.
+     */
+    static constexpr uint8_t NODE_ID = 10;
+
+    /**
+     * Utility variable which can be used to count the number of attempts that
+     * was made to complete a certain actions.
+     *
+     * For example, this is used for checking the STO N
+     * number of times before failing
+     */
+    uint16_t numAttemptsMade = 0;
+    /** Time the last STO attempt was counted, in milliseconds */
+    uint32_t lastAttemptTime = 0;
+    /** Time the last BMS reset burst was sent, in milliseconds */
+    uint32_t lastBMSResetTime = 0;
+
+    /**
+     * Registers the e-stop interrupt. From then on a falling edge on the
+     * e-stop input turns off precharge and the APM and starts opening the
+     * contactor straight from the interrupt, instead of waiting for the
+     * state machine to poll the input and pass through FORWARD_DISABLE. The
+     * state machine catches up on its next pass.
+     */
+    void enableEStopInterrupt();
+
+    /**
+     * Get the e-stop interrupt counters. The latency covers the handler
+     * itself, not the interrupt entry before it.
+     *
+     * @return The e-stop interrupt counters
+     */
+    EStopStats getEStopStats() const;
+
+    /**
+     * Get the queue the state machine's frames go out through. Each pass
+     * drains it; draining it from the main loop as well gets anything the
+     * mailboxes could not take out sooner.
+     *
+     * @return The transmit queue
+     */
+    CANTxQueue& getTxQueue();
+
+    /**
+     * Get the receive filter the CAN interrupt should hand every frame to.
+     * It already accepts this node's CANopen IDs, which go to the CANopen
+     * queue, and the GFDB responses.
+     *
+     * @return The receive filter
+     */
+    CANDispatcher& getCANDispatcher();
+
+    /**
+     * Get the queue the CANopen frames are received into. The CANopen
+     * stack's CAN driver should come from CANopenQueue::getDriver().
+     *
+     * @return The CANopen receive queue
+     */
+    CANopenQueue& getCANopenQueue();
+
+    /**
+     * Get the discharge counters
+     *
+     * @return The discharge counters
+     */
+    const WaitStats& getDischargeStats() const;
+
+    /**
+     * Get the forward disable counters. Timeouts are the forward disables
+     * the motor controller never confirmed.
+     *
+     * @return The forward disable counters
+     */
+    const WaitStats& getForwardDisableStats() const;
+
+    /**
+     * Get the execution time of a state's handler, in CycleCounter ticks
+     *
+     * @param[in] s State to get the statistics of
+     * @return Statistics of every pass the state machine made in s
+     */
+    const CycleStats& getStateStats(State s) const;
+
+    /**
+     * Get the execution time of getSTO(), in CycleCounter ticks
+     *
+     * @return Statistics of every getSTO() call made by the state machine
+     */
+    const CycleStats& getSTOStats() const;
+
+    /**
+     * Get the latest GFDB readings. These are refreshed in the background by
+     * handle(), so reading them costs no bus traffic.
+     *
+     * @return The cached GFDB snapshot
+     */
+    const GFDB::GFDBPoller::Snapshot& getGFDBSnapshot() const;
+
+    /**
+     * Update the STO (Safe to Operate) field of changePDO from this pass's
+     * input snapshot and ADC sample
+     *
+     * STO is HIGH when BATTERY_1_OK, BATTERY_2_OK and EMERGENCY_STOP are all
+     * HIGH, the pack is above MIN_PACK_MILLIVOLTS and, once precharge has
+     * completed, the GFDB reports the isolation as good. From 5 seconds
+     * after precharge completes, an isolation state older than GFDB_MAX_AGE
+     * counts as bad.
+     *
+     * A failed check does not drop STO at once. The field keeps its last
+     * value while attempts are counted, at most one per STO_ATTEMPT_PERIOD,
+     * so a fault has to last about MAX_STO_ATTEMPTS * STO_ATTEMPT_PERIOD
+     * milliseconds before STO goes LOW. A passing check resets the count.
+     * With LATCH_KEY_CYCLE, an active e-stop drops STO on the first failed
+     * check, and a timed out STO latches until the key is cycled.
+     */
+    void getSTO();
+
+    /**
+     * Get the state of MC_KEY_IN
+     *
+     */
+    void getMCKey();
+
+    /**
+     * Get the state of all IO instances and update IOStatus
+     */
+    void getIOStatus();
+
+    /**
+     * Set the Precharge state
+     *
+     * @param state 0 = precharge disabled, 1 = precharge enabled
+     */
+    void setPrecharge(PinStatus state);
+
+    /**
+     * Set the Discharge state
+     *
+     * @param state 0 = discharge disabled, 1 = discharge enabled
+     */
+    void setDischarge(PinStatus state);
+
+    /**
+     * Set the APM state
+     *
+     * @param state 0 = APM disabled, 1 = APM enabled
+     */
+    void setAPM(PinStatus state);
+
+    /**
+     * Handles when the MC is powered off.
+     *
+     * State: State::MC_OFF
+     */
+    void mcOffState();
+
+    /**
+     * Handles when the MC is powered on.
+     *
+     * State: State::MC_ON
+     */
+    void mcOnState();
+
+    /**
+     * Handles when an unsafe condition is detected while the MC is off.
+     *
+     * State: State::ESTOPWAIT
+     */
+    void eStopState();
+
+    /**
+     * Handles when discharge is to occur.
+     *
+     * State: State::DISCHARGE
+     */
+    void dischargeState();
+
+    /**
+     * Handles when the contactor is to be open.
+     *
+     * State: State::CONT_OPEN
+     */
+    void contOpenState();
+
+    /**
+     * Handles when the contactor is to be closed.
+     *
+     * State: State::CONT_CLOSE
+     */
+    void contCloseState();
+
+    /**
+     * Handles when the Forward Enable is to be disabled.
+     *
+     * State: State::FORWARD_DISABLE
+     */
+    void forwardDisableState();
+
+protected:
+    /**
+     * Constructor for pre-charge state machine
+     *
+     * @param[in] key GPIO for motorcycle key
+     * @param[in] batteryOne GPIO for battery ok signal
+     * @param[in] batteryTwo GPIO for battery ok signal
+     * @param[in] eStop GPIO for motorcycle e-stop
+     * @param[in] pc GPIO for precharge contactor
+     * @param[in] dc GPIO for discharge contactor
+     * @param[in] cont Driver for main contactor
+     * @param[in] apm GPIO for apm control
+     * @param[in] gfdb GPIO for gfdb fault signal
+     * @param[in] can can instance for CANopen
+     * @param[in] MAX ADC measuring the output and pack voltage
+     */
+    PreChargeCore(IO::GPIO& key, IO::GPIO& batteryOne, IO::GPIO& batteryTwo,
+                  IO::GPIO& eStop, IO::GPIO& pc, IO::GPIO& dc, Contactor& cont,
+                  IO::GPIO& apm, GFDB::GFDB& gfdb, IO::CAN& can, MAX22530 MAX);
+
+    /**
+     * Runs one pass of the state machine: updates STO, the key and the IO
+     * status, catches up on an e-stop taken by the interrupt and calls the
+     * handler of the current state from the variant's transition table.
+     */
+    void runStateMachine();
+
+    /** GPIO instance to monitor KEY_IN */
+    IO::GPIO& key;
+    /** GPIO instance to monitor BATTERY_1_OK */
+    IO::GPIO& batteryOne;
+    /** GPIO instance to monitor BATTERY_2_OK */
+    IO::GPIO& batteryTwo;
+    /** GPIO instance to monitor ESTOP_STATUS */
+    IO::GPIO& eStop;
+    /** GPIO instance to toggle PC_CTL */
+    IO::GPIO& pc;
+    /** GPIO instance to toggle DC_CTL */
+    IO::GPIO& dc;
+    /** Contactor instance to control the main contactor */
+    Contactor& cont;
+    /** GPIO instance to toggle APM_CTL */
+    IO::GPIO& apm;
+    /** GPIO instance to toggle FW_EN_CTL */
+    //    IO::GPIO& forward;
+    /** GFDB instance to handle isolation status*/
+    GFDB::GFDB& gfdb;
+    /** Keeps the cached GFDB readings up to date */
+    GFDB::GFDBPoller gfdbPoller;
+    /** Snapshot of the IO each pass works from, safety inputs debounced */
+    InputSampler inputs;
+    /** CAN instance to handle CANOpen processes*/
+    IO::CAN& can;
+    /** Frames the state machine sends, put on the bus at the end of each pass */
+    CANTxQueue txQueue;
+    /** Filters received frames and routes them, from the CAN interrupt */
+    CANDispatcher canDispatcher;
+    /** Received CANopen frames, waiting for the CANopen stack */
+    CANopenQueue canOpenQueue;
+
+    MAX22530 MAX;
+    /** ADC readings the current pass works from */
+    MAX22530::Sample adcSample = {};
+    /** Time adcSample was taken, in milliseconds */
+    uint32_t adcSampleTime = 0;
+
+    /**
+     * Get an IO status field of changePDO
+     *
+     * @param[in] field Field to read, not STATUS_STATE
+     * @return The field, HIGH if it is set
+     */
+    IO::GPIO::State getStatus(StatusBit field) const {
+        return static_cast<IO::GPIO::State>((changePDO >> field) & STATUS_FIELD_MASK);
+    }
+
+    /**
+     * Set an IO status field of changePDO
+     *
+     * @param[in] field Field to write, not STATUS_STATE
+     * @param[in] value New value of the field, 0 or 1
+     */
+    void setStatus(StatusBit field, uint8_t value) {
+        changePDO = (changePDO & ~(STATUS_FIELD_MASK << field)) | static_cast<uint64_t>(value) << field;
+    }
+
+    /**
+     * Set an IO status field of changePDO from a pin level
+     *
+     * @param[in] field Field to write, not STATUS_STATE
+     * @param[in] value New value of the field
+     */
+    void setStatus(StatusBit field, IO::GPIO::State value) {
+        setStatus(field, static_cast<uint8_t>(value));
+    }
+
+    uint8_t gfdStatus;
+    uint32_t lastPrechargeTime;
+
+    // Status bit to indicate a precharge error
+    // Key must be cycled (on->off->on) to resume state machine
+    uint8_t cycle_key;
+
+    State state;
+    uint64_t state_start_time;
+    int in_precharge;
+
+    /** Set by the e-stop interrupt until the state machine has reacted to it */
+    volatile bool eStopLatched = false;
+    /** Number of e-stop interrupts taken */
+    volatile uint32_t eStopCount = 0;
+    /** Duration of the last e-stop interrupt up to the outputs being safe, in CycleCounter ticks */
+    volatile uint32_t eStopLastTicks = 0;
+    /** Longest eStopLastTicks seen */
+    volatile uint32_t eStopMaxTicks = 0;
+
+    /** Execution time of each state's handler, indexed by State */
+    CycleStats stateStats[NUM_STATES] = {};
+    /** Execution time of getSTO() */
+    CycleStats stoStats = {};
+
+    /** Output voltage below which discharge is complete, in millivolts */
+    uint32_t dischargeSafeMillivolts = DISCHARGE_SAFE_MILLIVOLTS;
+    /** Time the output went below the safe voltage, valid while dischargeSafe is set */
+    uint32_t dischargeSafeTime = 0;
+    /** Whether the output is below the safe voltage */
+    bool dischargeSafe = false;
+    /** Discharge counters */
+    WaitStats dischargeStats = {};
+
+    /**
+     * Status of the motor controller, written by the CANopen stack as its
+     * RPDO comes in. Set to a value that does not confirm on entering
+     * FORWARD_DISABLE, so only a status sent after that counts.
+     */
+    uint16_t mcStatus = 0;
+    /** Bits of mcStatus compared to mcDisabledValue, 0 to not wait for confirmation */
+    uint16_t mcDisabledMask = MC_DISABLED_MASK;
+    /** Masked mcStatus of a disabled motor controller */
+    uint16_t mcDisabledValue = MC_DISABLED_VALUE;
+    /** Forward disable counters */
+    WaitStats forwardDisableStats = {};
+
+    /**
+     * Moves to FORWARD_DISABLE, starting its timeout and waiting for a
+     * fresh motor controller status
+     */
+    void enterForwardDisable();
+
+    /** changePDO as last sent, what the next pass is compared against */
+    uint64_t sentChangePDO = 0;
+    /** Bits of changePDO that send a change PDO when they change */
+    uint64_t changePDOTrigger = CHANGE_PDO_TRIGGER;
+
+    /**
+     * Sends changePDO as the change PDO, laid out as the variant's
+     * CHANGE_PDO_FIELDS and CHANGE_PDO_PASS_STATE select. Run at the end of
+     * every pass of the state machine for any change under changePDOTrigger
+     * in a field the variant sends.
+    */
+    void sendChangePDO();
+
+    /**
+     * Sends a frame to the TMS
+     *
+     * @param[in] payload Variant's TMS_WAKE_PAYLOAD or TMS_PRE_OP_PAYLOAD
+     * @param[in] size Length of the payload
+     */
+    void sendTMS(const uint8_t* payload, uint8_t size);
+
+private:
+    /**
+     * Interrupt handler for the e-stop input. Drives the outputs to a safe
+     * state and latches the e-stop for the state machine.
+     *
+     * @param[in] pin The e-stop input
+     * @param[in] priv The pre-charge controller
+     */
+    static void eStopIRQHandler(IO::GPIO* pin, void* priv);
+
+    /**
+     * Receive handler for the GFDB responses
+     *
+     * @param[in] message The received frame
+     * @param[in] priv The GFDB
+     */
+    static void gfdbCANHandler(IO::CANMessage& message, void* priv);
+
+    /**
+     * Brings the state machine in line with an e-stop taken by the
+     * interrupt. The outputs are already safe, so the contactor open is
+     * started without waiting out FORWARD_DISABLE.
+     */
+    void handleEStopLatch();
+};
+
+}// namespace PreCharge
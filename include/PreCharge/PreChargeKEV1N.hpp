@@ -8,8 +8,11 @@
 #include <EVT/io/UART.hpp>
 #include <EVT/io/pin.hpp>
 #include <PreCharge/GFDB.hpp>
+#include <PreCharge/GFDBPoller.hpp>
+#include <PreCharge/PreChargeCore.hpp>
 #include <PreCharge/dev/Contactor.hpp>
 #include <PreCharge/dev/MAX22530.hpp>
+#include <PreCharge/utils/CycleStats.hpp>
 #include <co_core.h>
 
 #include <math.h>
@@ -19,103 +22,37 @@ namespace IO = EVT::core::IO;
 namespace PreCharge {
 
 /**
- * Represents the pre-charge controller used for DEV1
+ * Represents the pre-charge controller used for KEV1N. Precharge is timed
+ * through the APM rather than checked against the RC curve, and the state
+ * machine holds in DISCHARGE and FORWARD_DISABLE once it gets there.
  */
-class PreChargeKEV1N : public CANDevice {
+class PreChargeKEV1N : public PreChargeCore<PreChargeKEV1N> {
 public:
-    /**
-     * Binary representation of the states that the pre-charge controller can be in
-     */
-    enum class State {
-        // When the MC is powered off
-        MC_OFF = 0u,
-        // When the MC is powered on
-        MC_ON = 1u,
-        // When the MC is in emergency state
-        ESTOPWAIT = 2u,
-        // When the MC is precharging
-        PRECHARGE = 3u,
-        // When the MC is discharging
-        DISCHARGE = 4u,
-        // When the contactor is open
-        CONT_OPEN = 5u,
-        // When the contactor is closed
-        CONT_CLOSE = 6u,
-        // When the forward enable is disabled
-        FORWARD_DISABLE = 7u
-    };
-
-    /** PVC Pinout */
-    static constexpr IO::Pin UART_TX_PIN = IO::Pin::PB_6;
-    static constexpr IO::Pin UART_RX_PIN = IO::Pin::PB_7;
-    static constexpr IO::Pin CAN_TX_PIN = IO::Pin::PA_12;
-    static constexpr IO::Pin CAN_RX_PIN = IO::Pin::PA_11;
-    static constexpr IO::Pin KEY_IN_PIN = IO::Pin::PF_1;
-    static constexpr IO::Pin BAT_OK_1_PIN = IO::Pin::PB_5;
-    static constexpr IO::Pin BAT_OK_2_PIN = IO::Pin::PB_4;
-    static constexpr IO::Pin ESTOP_IN_PIN = IO::Pin::PF_0;
-    static constexpr IO::Pin PC_CTL_PIN = IO::Pin::PA_3;
-    static constexpr IO::Pin DC_CTL_PIN = IO::Pin::PA_4;
-    static constexpr IO::Pin APM_CTL_PIN = IO::Pin::PA_2;
-    static constexpr IO::Pin CONT1_PIN = IO::Pin::PA_10;
-    static constexpr IO::Pin CONT2_PIN = IO::Pin::PA_9;
-    static constexpr IO::Pin SPI_CS = IO::Pin::PB_0;
-    static constexpr IO::Pin SPI_MOSI = IO::Pin::PA_7;
-    static constexpr IO::Pin SPI_MISO = IO::Pin::PA_6;
-    static constexpr IO::Pin SPI_SCK = IO::Pin::PA_5;
-    static constexpr IO::Pin SPI_INT = IO::Pin::PA_8;
-
-    enum class PinStatus {
-        DISABLE = 0u,
-        ENABLE = 1u,
-        HOLD = 2u
-    };
-
-    enum class PrechargeStatus {
-        OK = 0u,
-        DONE = 1u,
-        ERROR = 2u
-    };
-
     enum class PVCStatus {
         PVC_OP = 0u,
         PVC_PRE_OP = 1u,
         PVC_NONE = 2u
     };
 
-    static PVCStatus pvcStatus;
-
-    uint8_t Statusword;//8
-
-    uint64_t InputVoltage; //16
-    uint16_t OutputVoltage;//16
-    uint16_t BasePTemp;    //16
-
-    uint64_t changePDO;
-    uint64_t cyclicPDO;
-
-    static constexpr uint16_t PRECHARGE_DELAY = 2000;      // 2 seconds
-    static constexpr uint16_t FORWARD_DISABLE_DELAY = 5000;// 5 seconds
-
-    static constexpr uint8_t MIN_PACK_VOLTAGE = 70;
-
-    static constexpr uint8_t CONST_R = 30;
-    static constexpr float CONST_C = 0.014;
+    static constexpr uint16_t PRECHARGE_DELAY = 2000;// 2 seconds
 
+    /** Recovers from failures without cycling the key */
+    static constexpr bool LATCH_KEY_CYCLE = false;
+    /** No BMS reset from the e-stop */
+    static constexpr bool BMS_RESET_ON_ESTOP = false;
+    /** Frame waking the TMS once the contactor is closed */
+    static constexpr uint8_t TMS_WAKE_PAYLOAD[] = {0x01};
+    /** Frame sending the TMS back to pre-op once the APM is off */
+    static constexpr uint8_t TMS_PRE_OP_PAYLOAD[] = {0x80};
+    /** KEV1N's change PDO has never carried the volt field */
+    static constexpr uint64_t CHANGE_PDO_FIELDS = ~(STATUS_FIELD_MASK << STATUS_VOLT);
     /**
-     * Number of attempts that will be made to check the STO status
-     * before failing
+     * Byte 0 of KEV1N's change PDO is the state the pass started in, so a
+     * transition is reported with the state being left
      */
-    static constexpr uint16_t MAX_STO_ATTEMPTS = 25;
-
-    /**
-     * Utility variable which can be used to count the number of attempts that
-     * was made to complete a certain actions.
-     *
-     * For example, this is used for checking the STO N
-     * number of times before failing
-     */
-    uint16_t numAttemptsMade = 0;
+    static constexpr bool CHANGE_PDO_PASS_STATE = true;
+    /** No RPDOs, so RPDO0's COB-ID is rejected by the receive filter */
+    static constexpr bool HAS_RPDO0 = false;
 
     /**
      * Constructor for pre-charge state machine
@@ -133,91 +70,14 @@ public:
      * @param[in] can can instance for CANopen
      */
     PreChargeKEV1N(IO::GPIO& key, IO::GPIO& batteryOne, IO::GPIO& batteryTwo,
-                   IO::GPIO& eStop, IO::GPIO& pc, IO::GPIO& dc, Contactor cont,
+                   IO::GPIO& eStop, IO::GPIO& pc, IO::GPIO& dc, Contactor& cont,
                    IO::GPIO& apm, GFDB::GFDB& gfdb, IO::CAN& can, MAX22530 MAX);
 
-    /**
-     * The node ID used to identify the device on the CAN network.
-     */
-    static constexpr uint8_t NODE_ID = 10;
-
     /**
      * Handler running the pre-charge state switching
      */
     PVCStatus handle(IO::UART& uart);
 
-    /**
-     * Get the value of STO (Safe to Operate)
-     *
-     * TODO: Update documentation
-     * STO=1 when BATTERY_1_OK=1 AND BATTERY_2_OK=1 AND EMERGENCY_STOP=1
-     *
-     * @return value of STO, 0 or 1
-     */
-    void getSTO();
-
-    /**
-     * Get the value of the Precharge compared against the ideal precharge voltage curve
-     *
-     * DONE signifies that the precharge system has reached the target voltage without any errors
-     * OK signifies that the precharge system is not at target voltage and there are no errors
-     * ERROR signifies that the precharge system has either lagged behind or overshot the ideal curve
-     *
-     * @return int value of PrechargeStatus enum
-    */
-    int getPrechargeStatus();
-
-    /**
-     * Requests and handles the isolation state from the SIM100
-    */
-    void checkGFDB();
-
-    /**
-     * Get the current expected voltage based on the current precharge time
-     *
-     * @return float value of expected voltage in Volts
-    */
-    uint16_t solveForVoltage(uint16_t pack_voltage, uint64_t delta_time);
-
-    /**
-     * Get the state of MC_KEY_IN
-     *
-     */
-    void getMCKey();
-
-    /**
-     * Get the state of all IO instances and update IOStatus
-     */
-    void getIOStatus();
-
-    /**
-     * Set the Precharge state
-     *
-     * @param state 0 = precharge disabled, 1 = precharge enabled
-     */
-    void setPrecharge(PinStatus state);
-
-    /**
-     * Set the Discharge state
-     *
-     * @param state 0 = discharge disabled, 1 = discharge enabled
-     */
-    void setDischarge(PinStatus state);
-
-    /**
-     * Set the APM state
-     *
-     * @param state 0 = APM disabled, 1 = APM enabled
-     */
-    void setAPM(PinStatus state);
-
-    /**
-     * Handles when the MC is powered off.
-     *
-     * State: State::MC_OFF
-     */
-    void mcOffState();
-
     /**
      * Handles when the MC is powered on.
      *
@@ -226,46 +86,25 @@ public:
     void mcOnState();
 
     /**
-     * Handles when an unsafe condition is detected while the MC is off.
-     *
-     * State: State::ESTOPWAIT
-     */
-    void eStopState();
-
-    /**
-     * Handles when precharge is to occur.
+     * Handles when precharge is to occur. Precharge runs through the APM for
+     * PRECHARGE_DELAY, over as many passes as that takes, with handle()
+     * reporting PVC_PRE_OP until it moves on to MC_ON.
      *
      * State: State::PRECHARGE
      */
     void prechargeState();
 
-    /**
-     * Handles when discharge is to occur.
-     *
-     * State: State::DISCHARGE
-     */
-    void dischargeState();
-
-    /**
-     * Handles when the contactor is to be open.
-     *
-     * State: State::CONT_OPEN
-     */
-    void contOpenState();
-
-    /**
-     * Handles when the contactor is to be closed.
-     *
-     * State: State::CONT_CLOSE
-     */
-    void contCloseState();
-
-    /**
-     * Handles when the Forward Enable is to be disabled.
-     *
-     * State: State::FORWARD_DISABLE
-     */
-    void forwardDisableState();
+    /** Handler of each State, in State order */
+    static constexpr StateHandler STATE_HANDLERS[NUM_STATES] = {
+        &PreChargeKEV1N::mcOffState,
+        &PreChargeKEV1N::mcOnState,
+        &PreChargeKEV1N::eStopState,
+        &PreChargeKEV1N::prechargeState,
+        nullptr,
+        &PreChargeKEV1N::contOpenState,
+        &PreChargeKEV1N::contCloseState,
+        nullptr,
+    };
 
     /**
      * Get a pointer to the start of the CANopen object dictionary.
@@ -284,63 +123,13 @@ public:
     uint8_t getNodeID() override;
 
 private:
-    /** GPIO instance to monitor KEY_IN */
-    IO::GPIO& key;
-    /** GPIO instance to monitor BATTERY_1_OK */
-    IO::GPIO& batteryOne;
-    /** GPIO instance to monitor BATTERY_2_OK */
-    IO::GPIO& batteryTwo;
-    /** GPIO instance to monitor ESTOP_STATUS */
-    IO::GPIO& eStop;
-    /** GPIO instance to toggle PC_CTL */
-    IO::GPIO& pc;
-    /** GPIO instance to toggle DC_CTL */
-    IO::GPIO& dc;
-    /** Contactor instance to control the main contactor */
-    Contactor cont;
-    /** GPIO instance to toggle APM_CTL */
-    IO::GPIO& apm;
-    /** GPIO instance to toggle FW_EN_CTL */
-    //    IO::GPIO& forward;
-    /** GFDB instance to handle isolation status*/
-    GFDB::GFDB& gfdb;
-    /** CAN instance to handle CANOpen processes*/
-    IO::CAN& can;
-
-    MAX22530 MAX;
-
-    IO::GPIO::State keyInStatus;
-    IO::GPIO::State stoStatus;
-    IO::GPIO::State batteryOneOkStatus;
-    IO::GPIO::State batteryTwoOkStatus;
-    IO::GPIO::State eStopActiveStatus;
-    IO::GPIO::State pcStatus;
-    IO::GPIO::State dcStatus;
-    uint8_t contStatus;
-    uint8_t voltStatus;
-    IO::GPIO::State apmStatus;
-
-    uint8_t gfdStatus;
-    uint32_t lastPrechargeTime;
-
     uint8_t pre_charged;
 
-    State state;
-    State prevState;
-    uint64_t state_start_time;
-    int in_precharge;
-    uint8_t initVolt;
-
-    /**
-     * Handles the sending of a CAN message upon each state change.
-    */
-    void sendChangePDO();
-
     /**
      * Have to know the size of the object dictionary for initialization
      * process.
      */
-    static constexpr uint8_t OBJECT_DICTIONARY_SIZE = 22;
+    static constexpr uint8_t OBJECT_DICTIONARY_SIZE = 81;
     /**
      * The object dictionary itself. Will be populated by this object during
      * construction.
@@ -376,6 +165,35 @@ private:
         DATA_LINK_START_KEY_21XX(0, 0x01),
         DATA_LINK_21XX(0x00, 0x01, CO_TUNSIGNED8, &state),
 
+        // Execution time profile, read only over SDO. Sub-index 1 to 4 hold
+        // the calls, min, max and average in CycleCounter ticks.
+        // 0x2101 - 0x2108: Each state's handler, in State order, with
+        //                  0x2105 and 0x2108 never called as KEV1N has no
+        //                  handler for those states
+        // 0x2109: getSTO()
+        // 0x210A: GFDB::process()
+        // 0x210B: MAX22530::readChannels()
+        CYCLE_STATS_LINK_21XX(0x01, stateStats[0]),
+        CYCLE_STATS_LINK_21XX(0x02, stateStats[1]),
+        CYCLE_STATS_LINK_21XX(0x03, stateStats[2]),
+        CYCLE_STATS_LINK_21XX(0x04, stateStats[3]),
+        CYCLE_STATS_LINK_21XX(0x05, stateStats[4]),
+        CYCLE_STATS_LINK_21XX(0x06, stateStats[5]),
+        CYCLE_STATS_LINK_21XX(0x07, stateStats[6]),
+        CYCLE_STATS_LINK_21XX(0x08, stateStats[7]),
+        CYCLE_STATS_LINK_21XX(0x09, stoStats),
+        CYCLE_STATS_LINK_21XX(0x0A, gfdb.getProcessStats()),
+        CYCLE_STATS_LINK_21XX(0x0B, MAX.getReadStats()),
+
+        // CANopen receive queue, read only
+        // 1: Frames the queue holds
+        // 2: Most frames it has held at once
+        // 3: Frames dropped as it was full
+        {CO_KEY(0x2116, 0, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (0x03)},
+        {CO_KEY(0x2116, 1, CO_OBJ_D___R_), CO_TUNSIGNED32, (CO_DATA) (CANopenQueue::SIZE)},
+        {CO_KEY(0x2116, 2, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&canOpenQueue.getStats().highWater)},
+        {CO_KEY(0x2116, 3, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&canOpenQueue.getStats().overruns)},
+
         // End of dictionary marker
         CO_OBJ_DICT_ENDMARK,
     };
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <co_core.h>
+
+#include <cstdint>
+
+namespace PreCharge {
+
+/**
+ * Records the voltage curve of the last few precharge attempts in RAM so
+ * they can be read off the vehicle over SDO.
+ *
+ * Each attempt has room for a fixed number of samples. At first a sample is
+ * kept every millisecond; once an attempt fills its slot, every other sample
+ * is dropped and the spacing doubles, so however long the precharge runs the
+ * slot always covers the whole curve at an even spacing. The sample an
+ * attempt ends on is always kept.
+ *
+ * Attempts are stored round robin, so the oldest is overwritten first. Each
+ * slot is linked into the object dictionary as a domain, which the CANopen
+ * stack serves with segmented or block upload. Its layout, little endian, is
+ * that of Attempt.
+ */
+class PrechargeTrace {
+public:
+    /** Number of attempts kept */
+    static constexpr uint8_t NUM_ATTEMPTS = 4;
+    /** Samples kept per attempt, even */
+    static constexpr uint8_t MAX_SAMPLES = 64;
+    /** Resolution of the voltages in a sample, in millivolts */
+    static constexpr int32_t MV_PER_COUNT = 10;
+
+    /**
+     * How an attempt ended
+     */
+    enum class Result : uint8_t {
+        /** The slot has not been used */
+        EMPTY = 0u,
+        /** The attempt is still running */
+        RUNNING = 1u,
+        /** The output reached the pack voltage */
+        DONE = 2u,
+        /** The output fell off the expected curve */
+        ERROR = 3u,
+        /** Precharge was stopped by the key, STO or e-stop */
+        ABORTED = 4u
+    };
+
+    /**
+     * One point on the curve
+     */
+    struct Sample {
+        /** Time since the attempt started, in milliseconds */
+        uint16_t time;
+        /** Measured output voltage, in MV_PER_COUNT */
+        uint16_t measured;
+        /** Expected output voltage, in MV_PER_COUNT */
+        uint16_t expected;
+        /** Pack voltage, in MV_PER_COUNT */
+        uint16_t pack;
+    };
+
+    /**
+     * A recorded attempt, as read over SDO
+     */
+    struct Attempt {
+        /** Counts up from 1 with each attempt, to order the slots */
+        uint16_t sequence;
+        /** Result cast to its underlying value */
+        uint8_t result;
+        /** Number of samples filled in */
+        uint8_t count;
+        /** Minimum time between samples, in milliseconds */
+        uint16_t stride;
+        /** Time closing early saved over waiting for the done window, in milliseconds */
+        uint16_t timeSaved;
+        /** time::millis() when the attempt started */
+        uint32_t startTime;
+        Sample samples[MAX_SAMPLES];
+    };
+
+    PrechargeTrace();
+
+    /**
+     * Starts recording a new attempt in the oldest slot, ending any attempt
+     * still running as aborted
+     *
+     * @param[in] now time::millis() when precharge started
+     */
+    void start(uint32_t now);
+
+    /**
+     * Adds a sample to the running attempt if it is at least the stride
+     * after the last one kept. Samples at the same time as the last one
+     * replace it.
+     *
+     * @param[in] elapsed Time since the attempt started, in milliseconds
+     * @param[in] measured Measured output voltage, in millivolts
+     * @param[in] expected Expected output voltage, in millivolts
+     * @param[in] pack Pack voltage, in millivolts
+     * @param[in] keep Keep the sample regardless of the decimation, for the
+     * sample an attempt ends on
+     */
+    void record(uint32_t elapsed, int32_t measured, int32_t expected, int32_t pack, bool keep = false);
+
+    /**
+     * Ends the running attempt, if any
+     *
+     * @param[in] result How the attempt ended
+     * @param[in] timeSaved Time saved by closing early, in milliseconds
+     */
+    void finish(Result result, uint16_t timeSaved = 0);
+
+    /**
+     * @return Whether an attempt is being recorded
+     */
+    bool isRunning() const;
+
+    /**
+     * @param[in] slot Slot to get, 0 to NUM_ATTEMPTS - 1
+     * @return The attempt in the slot
+     */
+    const Attempt& getAttempt(uint8_t slot) const;
+
+    /**
+     * @param[in] slot Slot to get, 0 to NUM_ATTEMPTS - 1
+     * @return CANopen domain covering the slot, to link into the object
+     * dictionary
+     */
+    CO_OBJ_DOM* getDomain(uint8_t slot);
+
+private:
+    static_assert(MAX_SAMPLES % 2 == 0, "PrechargeTrace must hold an even number of samples");
+
+    /** The recorded attempts */
+    Attempt attempts[NUM_ATTEMPTS] = {};
+    /** Domains handed to the CANopen stack, one per slot */
+    CO_OBJ_DOM domains[NUM_ATTEMPTS] = {};
+    /** Slot of the running or last attempt */
+    uint8_t current = NUM_ATTEMPTS - 1;
+    /** Sequence number of the last attempt started */
+    uint16_t sequence = 0;
+
+    /**
+     * Converts millivolts to a sample voltage, saturating
+     *
+     * @param[in] millivolts Voltage in millivolts
+     * @return Voltage in MV_PER_COUNT
+     */
+    static uint16_t toCounts(int32_t millivolts);
+};
+
+}// namespace PreCharge
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+
+namespace PreCharge {
+
+/**
+ * Fixed point lookup table of the RC charging curve 1 - e^(-t/RC), indexed
+ * by elapsed milliseconds.
+ *
+ * The table is generated at compile time, so evaluating the curve at run
+ * time is a single load instead of a double precision exp() call, which is
+ * a soft-float library call on the Cortex-M4F. Values are unsigned Q0.16
+ * (65536 = 1.0). Past the end of the table the curve is treated as fully
+ * charged.
+ *
+ * @tparam TAU_MS RC time constant in milliseconds
+ * @tparam LENGTH Number of milliseconds covered by the table
+ */
+template<uint32_t TAU_MS, uint32_t LENGTH = 5 * TAU_MS>
+class RCCurve {
+public:
+    /** Number of milliseconds covered by the table */
+    static constexpr uint32_t SIZE = LENGTH;
+
+    /** RC time constant of the curve in milliseconds */
+    static constexpr uint32_t TAU = TAU_MS;
+
+    /** Number of fractional bits of the table values */
+    static constexpr uint8_t FRACTION_BITS = 16;
+
+    /** Value returned once the table has run out, the largest value below 1.0 */
+    static constexpr uint16_t FULL_SCALE = 0xFFFF;
+
+    /**
+     * Get 1 - e^(-t/RC) for the given elapsed time
+     *
+     * @param[in] ms Time since the start of the charge in milliseconds
+     * @return The fraction of the final voltage reached, Q0.16
+     */
+    static constexpr uint16_t lookup(uint64_t ms) {
+        return ms < LENGTH ? TABLE.values[ms] : FULL_SCALE;
+    }
+
+    /**
+     * Get the voltage on the curve after a given time
+     *
+     * @param[in] start Voltage at the start of the charge
+     * @param[in] target Voltage being charged towards
+     * @param[in] ms Time since the start of the charge in milliseconds
+     * @return The expected voltage, in the same units as start and target
+     */
+    static constexpr int32_t solve(int32_t start, int32_t target, uint64_t ms) {
+        return start + static_cast<int32_t>((static_cast<int64_t>(target - start) * lookup(ms)) >> FRACTION_BITS);
+    }
+
+    /**
+     * Get the time at which the curve reaches a fraction of the final
+     * voltage, the inverse of lookup(). Interpolates between table entries.
+     *
+     * @param[in] fraction Fraction of the final voltage, Q0.16
+     * @return Time since the start of the charge in 1/256 milliseconds,
+     * clamped to the end of the table
+     */
+    static constexpr uint32_t invert(uint16_t fraction) {
+        // First entry at or above the fraction, the table is increasing
+        uint32_t low = 0;
+        uint32_t high = LENGTH - 1;
+        if (fraction >= TABLE.values[high]) {
+            return high << 8;
+        }
+        while (low < high) {
+            uint32_t mid = (low + high) / 2;
+            if (TABLE.values[mid] < fraction) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        if (low == 0) {
+            return 0;
+        }
+
+        uint32_t below = TABLE.values[low - 1];
+        uint32_t above = TABLE.values[low];
+        return ((low - 1) << 8) + ((fraction - below) << 8) / (above - below);
+    }
+
+private:
+    struct Table {
+        uint16_t values[LENGTH];
+
+        constexpr Table() : values() {
+            // e^(-1/TAU) from its Taylor series, x is small enough that a
+            // handful of terms is exact to double precision
+            double x = 1.0 / TAU_MS;
+            double step = 1.0;
+            double term = 1.0;
+            for (uint8_t n = 1; n < 12; n++) {
+                term *= -x / n;
+                step += term;
+            }
+
+            // e^(-t/TAU) = (e^(-1/TAU))^t
+            double decay = 1.0;
+            for (uint32_t t = 0; t < LENGTH; t++) {
+                double value = (1.0 - decay) * (1u << FRACTION_BITS) + 0.5;
+                values[t] = value >= FULL_SCALE ? FULL_SCALE : static_cast<uint16_t>(value);
+                decay *= step;
+            }
+        }
+    };
+
+    static constexpr Table TABLE{};
+};
+
+}// namespace PreCharge
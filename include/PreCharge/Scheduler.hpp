@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace PreCharge {
+
+/**
+ * Cooperative rate-monotonic scheduler for the main loop.
+ *
+ * Periodic tasks are released every period milliseconds and dispatched
+ * shortest period first; after each task the search starts again from the
+ * top, so a due high rate task always runs before a lower rate one. Tasks
+ * with a period of 0 run once per pass after every due periodic task, in the
+ * order they were added, and are meant for servicing that should happen as
+ * often as possible (CANopen) or only when there is time (logging).
+ *
+ * Tasks are never preempted, so each must return quickly. A periodic task
+ * misses a deadline when it has not started by its next release, as one
+ * that overran its period starts late the next time; missed releases are
+ * skipped rather than run back to back, and counted. A task that finishes
+ * just past a tick has not missed anything and keeps every release.
+ */
+class Scheduler {
+public:
+    /**
+     * A task function
+     *
+     * @param[in] priv Private data passed to addTask()
+     */
+    using Task = void (*)(void* priv);
+
+    /**
+     * Run time statistics of a task
+     */
+    struct TaskStats {
+        /** Number of times the task ran */
+        uint32_t runs;
+        /** Deadlines missed, periodic tasks only */
+        uint32_t misses;
+        /** Longest time between release and start in milliseconds, periodic tasks only */
+        uint32_t maxLateness;
+        /** Longest run time in milliseconds */
+        uint32_t maxRuntime;
+    };
+
+    /** Maximum number of tasks */
+    static constexpr uint8_t MAX_TASKS = 8;
+
+    /** Returned by addTask() when the task table is full */
+    static constexpr uint8_t INVALID_TASK = 0xFF;
+
+    /**
+     * Adds a task. Periodic tasks are first released one period after they
+     * are added.
+     *
+     * @param[in] task Function to run
+     * @param[in] priv Private data passed to the function
+     * @param[in] period Release period in milliseconds, 0 to run on every pass
+     * @return ID of the task for getStats(), INVALID_TASK if the table is full
+     */
+    uint8_t addTask(Task task, void* priv, uint32_t period);
+
+    /**
+     * Runs every periodic task that is due, highest rate first, then every
+     * task with a period of 0
+     */
+    void runOnce();
+
+    /**
+     * Runs the scheduler forever
+     */
+    [[noreturn]] void run();
+
+    /**
+     * @param[in] id ID returned by addTask()
+     * @return Run time statistics of the task
+     */
+    const TaskStats& getStats(uint8_t id) const;
+
+    /**
+     * @return Number of tasks added
+     */
+    uint8_t getNumTasks() const;
+
+private:
+    /**
+     * A scheduled task
+     */
+    struct Entry {
+        /** Function to run */
+        Task task;
+        /** Private data passed to the function */
+        void* priv;
+        /** Release period in milliseconds, 0 to run on every pass */
+        uint32_t period;
+        /** Time of the next release in milliseconds */
+        uint32_t release;
+        /** Run time statistics */
+        TaskStats stats;
+    };
+
+    /** Tasks in the order they were added, indexed by ID */
+    Entry tasks[MAX_TASKS] = {};
+
+    /** Task IDs in dispatch order: periodic tasks by period, then the rest */
+    uint8_t order[MAX_TASKS] = {};
+
+    /** Number of tasks added */
+    uint8_t numTasks = 0;
+
+    /**
+     * Runs a task and updates its run count and run time
+     *
+     * @param[in] entry Task to run
+     */
+    static void execute(Entry& entry);
+};
+
+}// namespace PreCharge
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstdint>
+
+namespace PreCharge {
+
+/**
+ * Estimates the RC time constant of the precharge circuit from the start of
+ * each precharge, so the expected curve follows capacitance and resistance
+ * drift instead of flagging it as a fault.
+ *
+ * Every sample is mapped back through the nominal curve to the time at
+ * which the nominal circuit would have reached the same fraction of the
+ * pack voltage. That time is the elapsed time scaled by TAU_NOMINAL / tau,
+ * so a least squares fit of the mapped times against the elapsed times,
+ * through the origin, gives the scale directly. Only integer sums are kept
+ * per sample and the nominal curve's lookup table stands in for ln(), so
+ * no floating point is needed.
+ *
+ * Samples are fitted for the first FIT_WINDOW_MS of a precharge, where the
+ * nominal curve and a drifted one are still within the tolerance band of
+ * each other. The fit then takes over the time scale, bounded to tau within
+ * 30% of nominal, and is kept as the starting point of the next precharge.
+ * A fit from fewer than MIN_SAMPLES samples is rejected, and the scale of
+ * the last accepted fit stays in use; hasFit() tells the two apart.
+ *
+ * @tparam Curve RCCurve of the nominal time constant
+ */
+template<typename Curve>
+class TauEstimator {
+public:
+    /** Scale of a circuit running at the nominal time constant, Q16.16 */
+    static constexpr uint32_t UNITY = 1u << 16;
+    /** Smallest scale, tau 30% above nominal */
+    static constexpr uint32_t MIN_SCALE = UNITY * 10 / 13;
+    /** Largest scale, tau 30% below nominal */
+    static constexpr uint32_t MAX_SCALE = UNITY * 10 / 7;
+    /** Length of the start of a precharge that is fitted, in milliseconds */
+    static constexpr uint32_t FIT_WINDOW_MS = Curve::TAU / 4;
+    /** Fewest samples a fit is accepted from */
+    static constexpr uint8_t MIN_SAMPLES = 8;
+    /** Samples below this fraction of the pack voltage are mostly noise, Q0.16 */
+    static constexpr uint16_t MIN_FRACTION = UNITY / 50;
+
+    /**
+     * Starts fitting a new precharge. The current scale is kept until the
+     * fit is done.
+     */
+    void start() {
+        sumElapsed = 0;
+        sumMapped = 0;
+        lastMs = 0;
+        count = 0;
+        fitting = true;
+        accepted = false;
+    }
+
+    /**
+     * Adds a sample to the fit, completing it once a sample past the fit
+     * window comes in
+     *
+     * @param[in] ms Time since the precharge started, in milliseconds
+     * @param[in] start Output voltage when precharge started
+     * @param[in] measured Output voltage now
+     * @param[in] target Pack voltage being charged towards
+     * @return true if this sample completed a fit and updated the scale
+     */
+    bool addSample(uint32_t ms, int32_t start, int32_t measured, int32_t target) {
+        if (!fitting || (count > 0 && ms <= lastMs)) {
+            return false;
+        }
+
+        if (ms >= FIT_WINDOW_MS) {
+            fitting = false;
+            if (count < MIN_SAMPLES) {
+                return false;
+            }
+            uint64_t fitted = (sumMapped << 8) / sumElapsed;
+            if (fitted < MIN_SCALE) {
+                fitted = MIN_SCALE;
+            } else if (fitted > MAX_SCALE) {
+                fitted = MAX_SCALE;
+            }
+            scale = static_cast<uint32_t>(fitted);
+            accepted = true;
+            return true;
+        }
+
+        int32_t span = target - start;
+        if (span <= 0 || measured <= start || count == UINT8_MAX) {
+            return false;
+        }
+        int64_t fraction = (static_cast<int64_t>(measured - start) << 16) / span;
+        if (fraction < MIN_FRACTION || fraction >= Curve::FULL_SCALE) {
+            return false;
+        }
+
+        // Time the nominal curve takes to the same fraction, 1/256 ms
+        uint32_t mapped = Curve::invert(static_cast<uint16_t>(fraction));
+        sumElapsed += static_cast<uint64_t>(ms) * ms;
+        sumMapped += static_cast<uint64_t>(ms) * mapped;
+        lastMs = ms;
+        count++;
+        return false;
+    }
+
+    /**
+     * Converts elapsed time to time on the nominal curve
+     *
+     * @param[in] ms Time since the precharge started, in milliseconds
+     * @return Where on the nominal curve the circuit is expected to be, in
+     * milliseconds
+     */
+    uint64_t scaleTime(uint64_t ms) const {
+        return (ms * scale) >> 16;
+    }
+
+    /**
+     * @return Whether the current precharge is still being fitted
+     */
+    bool isFitting() const {
+        return fitting;
+    }
+
+    /**
+     * @return Whether the current precharge's fit completed and was accepted,
+     * so the scale was measured on this precharge
+     */
+    bool hasFit() const {
+        return accepted;
+    }
+
+    /**
+     * @return TAU_NOMINAL / tau, Q16.16
+     */
+    uint32_t getScale() const {
+        return scale;
+    }
+
+    /**
+     * @return Estimated time constant in milliseconds
+     */
+    uint32_t getTau() const {
+        return static_cast<uint32_t>((static_cast<uint64_t>(Curve::TAU) << 16) / scale);
+    }
+
+private:
+    /** Current time scale, Q16.16 */
+    uint32_t scale = UNITY;
+    /** Sum of elapsed time squared */
+    uint64_t sumElapsed = 0;
+    /** Sum of elapsed time times mapped time */
+    uint64_t sumMapped = 0;
+    /** Elapsed time of the last sample fitted, repeats are skipped */
+    uint32_t lastMs = 0;
+    /** Number of samples fitted */
+    uint8_t count = 0;
+    /** Whether the current precharge is still being fitted */
+    bool fitting = false;
+    /** Whether the current precharge's fit was accepted */
+    bool accepted = false;
+};
+
+}// namespace PreCharge
@@ -2,23 +2,118 @@
 #define PRE_CHARGE_INCLUDE_PRECHARGE_DEV_CONTACTOR_HPP
 
 #include <EVT/io/GPIO.hpp>
+#include <cstdint>
 
 namespace IO = EVT::core::IO;
 
 namespace PreCharge {
 
+/**
+ * Driver for the latching main contactor. The contactor is opened by pulsing
+ * cont1 and closed by pulsing cont2.
+ *
+ * Actuations are non-blocking: requestOpen() starts the coil pulse and
+ * process() ends it once PULSE_DURATION has elapsed. process() has to be
+ * called periodically, either from a timer tick or from the control loop,
+ * but only from one of those contexts. Requests made while a pulse is in
+ * progress are queued and started once the current pulse ends, so both
+ * coils are never energized at the same time.
+ *
+ * emergencyOpen() is the one exception and may be called from an interrupt
+ * handler at any time. It drives the coils itself and leaves it to the next
+ * process() call to take over timing the pulse. A close pulse that starts
+ * while it lands checks for it again once cont2 is driven and releases cont2
+ * straight away, so the coils overlap for a few instructions at most.
+ */
 class Contactor {
 public:
+    /**
+     * Progress of the most recent actuation request
+     */
+    enum class Actuation {
+        // No actuation in progress, the contactor is in the requested position
+        IDLE = 0u,
+        // Waiting for the pulse of a previous request to finish
+        PENDING = 1u,
+        // Coil is being pulsed
+        PULSING = 2u
+    };
+
+    /** Length of a coil pulse in milliseconds */
+    static constexpr uint32_t PULSE_DURATION = 20;
+
     Contactor(IO::GPIO& cont1, IO::GPIO& cont2);
 
+    /**
+     * Open or close the contactor, blocking until the coil pulse is done
+     *
+     * @param[in] shouldOpen true to open the contactor, false to close it
+     */
     void setOpen(bool shouldOpen);
 
+    /**
+     * Start opening or closing the contactor without waiting for the pulse
+     * to complete. Progress is reported by getActuation().
+     *
+     * @param[in] shouldOpen true to open the contactor, false to close it
+     */
+    void requestOpen(bool shouldOpen);
+
+    /**
+     * Start an open pulse straight away, overriding any actuation in
+     * progress. Safe to call from interrupt context. Close requests are
+     * ignored until process() has picked up the emergency pulse.
+     */
+    void emergencyOpen();
+
+    /**
+     * Advance the pulse scheduler, ending a pulse that has run its course
+     * and starting a queued one
+     */
+    void process();
+
+    /**
+     * @return Progress of the most recent actuation request
+     */
+    Actuation getActuation();
+
+    /**
+     * Get the measured time of the last completed actuation, from the
+     * request until the end of the coil pulse
+     *
+     * @return Actuation time in milliseconds
+     */
+    uint32_t getActuationTime();
+
+    /**
+     * @return true if the contactor was last actuated open
+     */
     bool openState();
 
 private:
     IO::GPIO& cont1;
     IO::GPIO& cont2;
     bool isOpen = true;
+
+    /** Position the contactor was last requested to be in */
+    bool targetOpen = true;
+    /** Direction of the pulse in progress, true for an open pulse */
+    bool pulsingOpen = true;
+    volatile Actuation actuation = Actuation::IDLE;
+    /** Set by emergencyOpen() until process() takes over the pulse */
+    volatile bool emergency = false;
+
+    /** Time the pulse in progress was started */
+    uint32_t pulseStartTime = 0;
+    /** Time the current request was made */
+    uint32_t requestTime = 0;
+    /** Measured duration of the last completed actuation */
+    uint32_t actuationTime = 0;
+
+    /**
+     * Energize the coil that moves the contactor towards targetOpen
+     */
+    void startPulse();
 };
 
 }// namespace PreCharge
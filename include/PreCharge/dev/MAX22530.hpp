@@ -1,5 +1,6 @@
 #pragma once
 #include <EVT/io/SPI.hpp>
+#include <PreCharge/utils/CycleStats.hpp>
 #include <cstdint>
 
 namespace IO = EVT::core::IO;
@@ -19,6 +20,73 @@ public:
      */
     explicit MAX22530(IO::SPI& spi);
 
+    /** Number of ADC channels, read from registers 0x01 to 0x04 */
+    static constexpr uint8_t NUM_CHANNELS = 4;
+
+    /** Mask selecting every ADC channel */
+    static constexpr uint8_t ALL_CHANNELS = 0x0F;
+
+    /**
+     * Raw readings of the ADC channels taken in a single transaction
+     */
+    struct Sample {
+        /** Raw ADC counts, index 0 holds register 0x01 */
+        uint16_t counts[NUM_CHANNELS];
+        /** Bit per channel, set for the channels filled in by the last read */
+        uint8_t mask;
+    };
+
+    /**
+     * Gets the mask bit of an ADC channel
+     *
+     * @param[in] reg Register of the channel, 0x01 to 0x04
+     * @return Mask bit for readChannels()
+     */
+    static constexpr uint8_t channelMask(uint16_t reg) {
+        return 1 << (reg - 1);
+    }
+
+    /**
+     * Nominal conversion gain in millivolts per count as Q16 fixed point:
+     * 1.8 V reference * 61 divider ratio / 4096 counts = 26.8066 mV
+     */
+    static constexpr uint32_t NOMINAL_GAIN = 1756800;
+
+    /** Calibration gain of exactly 1.0 as Q16 fixed point */
+    static constexpr uint32_t UNITY_GAIN = 1 << 16;
+
+    /**
+     * Sets the calibration of a channel. The gain scales the nominal
+     * conversion and the offset is added after it, so
+     * mV = count * NOMINAL_GAIN * gain + offset.
+     *
+     * @param[in] reg Register of the channel, 0x01 to 0x04
+     * @param[in] gain Gain correction as Q16 fixed point, UNITY_GAIN for none
+     * @param[in] offset Offset correction in millivolts
+     */
+    void setCalibration(uint16_t reg, uint32_t gain, int32_t offset);
+
+    /**
+     * Converts a raw reading to millivolts using the channel's calibration.
+     * A single 32x32 bit multiply and shift, no divide.
+     *
+     * @param[in] reg Register of the channel, 0x01 to 0x04
+     * @param[in] count Raw ADC count
+     * @return The voltage (millivolts)
+     */
+    int32_t convertToMillivolts(uint16_t reg, uint16_t count) const {
+        uint8_t channel = reg - 1;
+        return static_cast<int32_t>((static_cast<uint64_t>(count) * scale[channel]) >> 16) + offset[channel];
+    }
+
+    /**
+     * Returns the voltage in millivolts
+     *
+     * @param[in] reg Register of the channel, 0x01 to 0x04
+     * @return The voltage (millivolts)
+     */
+    int32_t readMillivolts(uint16_t reg);
+
     /**
      * Returns the voltage in decivolts
      *
@@ -26,11 +94,69 @@ public:
      */
     uint8_t readVoltage(uint16_t reg);
 
+    /**
+     * Reads the selected ADC channels in one chip select burst so they are
+     * sampled together. The burst covers the lowest to the highest selected
+     * channel; channels not selected are left untouched in the sample.
+     *
+     * @param[in] mask Channels to read, see channelMask()
+     * @param[out] sample Sample to store the readings in
+     * @return Status of the SPI transaction
+     */
+    IO::SPI::SPIStatus readChannels(uint8_t mask, Sample& sample);
+
+    /**
+     * Reads all four ADC channels in one chip select burst
+     *
+     * @param[out] sample Sample to store the readings in
+     * @return Status of the SPI transaction
+     */
+    IO::SPI::SPIStatus readAll(Sample& sample);
+
+    /**
+     * Gets the voltage of a channel from a sample
+     *
+     * @param[in] sample Sample holding the channel
+     * @param[in] reg Register of the channel, 0x01 to 0x04
+     * @return The voltage (millivolts)
+     */
+    int32_t getMillivolts(const Sample& sample, uint16_t reg) const;
+
+    /**
+     * Gets the voltage of a channel from a sample
+     *
+     * @param[in] sample Sample holding the channel
+     * @param[in] reg Register of the channel, 0x01 to 0x04
+     * @return The voltage (decivolts)
+     */
+    uint8_t getVoltage(const Sample& sample, uint16_t reg) const;
+
+    /**
+     * @return Execution time of readChannels(), SPI transaction included
+     */
+    const CycleStats& getReadStats() const;
+
 private:
     /** The SPI interface to read from */
     IO::SPI& spi;
-    /** Function that converts raw ADC values into decivolts */
-    static uint8_t convertToVoltage(uint16_t count);
+    /** Per channel conversion gain, NOMINAL_GAIN with the calibration applied */
+    uint32_t scale[NUM_CHANNELS];
+    /** Per channel calibration offset in millivolts */
+    int32_t offset[NUM_CHANNELS];
+    /** Execution time of readChannels() */
+    CycleStats readStats = {};
+
+    /**
+     * Carries out readChannels()
+     *
+     * @param[in] mask Channels to read, see channelMask()
+     * @param[out] sample Sample to store the readings in
+     * @return Status of the SPI transaction
+     */
+    IO::SPI::SPIStatus burstRead(uint8_t mask, Sample& sample);
+
+    /** Function that converts millivolts into the units of readVoltage() */
+    static uint8_t convertToVoltage(int32_t millivolts);
 };
 
 }// namespace PreCharge
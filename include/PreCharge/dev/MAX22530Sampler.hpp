@@ -0,0 +1,146 @@
+#pragma once
+
+#include <EVT/dev/Timer.hpp>
+#include <EVT/io/GPIO.hpp>
+#include <PreCharge/dev/MAX22530.hpp>
+#include <PreCharge/utils/SPSCQueue.hpp>
+
+namespace IO = EVT::core::IO;
+namespace DEV = EVT::core::DEV;
+
+namespace PreCharge {
+
+/**
+ * Samples the MAX22530 from interrupt context into a lock-free queue, so
+ * the voltages are seen at the pace of a hardware timer or the ADC's data
+ * ready interrupt instead of the main loop. Each sample is one burst read
+ * of the selected channels, stamped with the time it was taken.
+ *
+ * The sampler owns the SPI bus while it is running; nothing else may read
+ * the MAX22530 until it is stopped.
+ */
+class MAX22530Sampler {
+public:
+    /**
+     * A sample and the time it was taken
+     */
+    struct TimedSample {
+        /** Channels read in the burst */
+        MAX22530::Sample sample;
+        /** Time the sample was taken, in milliseconds */
+        uint32_t timestamp;
+    };
+
+    /** Number of samples buffered, enough for 100 ms at the fastest rate */
+    static constexpr size_t QUEUE_SIZE = 128;
+
+    /** Fastest supported sample rate in Hz, one sample per 1 ms timer tick */
+    static constexpr uint32_t MAX_RATE = 1000;
+
+    /**
+     * Constructor for the MAX22530Sampler
+     *
+     * @param[in] max ADC to sample
+     * @param[in] mask Channels to read on each sample, see MAX22530::channelMask()
+     */
+    MAX22530Sampler(MAX22530& max, uint8_t mask);
+
+    /**
+     * Starts sampling on every tick of a hardware timer. Only one sampler
+     * can be paced by a timer at a time.
+     *
+     * @param[in] timer Timer to pace the samples, with a period of at least 1 ms
+     */
+    void start(DEV::Timer& timer);
+
+    /**
+     * Starts sampling on the falling edge of the MAX22530 interrupt output
+     * (SPI_INT). The ADC must be configured to assert it on end of conversion.
+     *
+     * @param[in] dataReady GPIO connected to the interrupt output
+     */
+    void start(IO::GPIO& dataReady);
+
+    /**
+     * Stops sampling. Samples already queued can still be popped.
+     */
+    void stop();
+
+    /**
+     * @return true if samples are being taken
+     */
+    bool isRunning() const;
+
+    /**
+     * Takes one sample and queues it. Called from the timer or data ready
+     * interrupt; may also be called directly to sample on demand.
+     */
+    void sample();
+
+    /**
+     * Removes the oldest sample from the queue. Must only be called from the
+     * main loop.
+     *
+     * @param[out] timedSample The oldest sample
+     * @return false if no sample was queued
+     */
+    bool pop(TimedSample& timedSample);
+
+    /**
+     * @return Time sampling was last started, in milliseconds
+     */
+    uint32_t getStartTime() const;
+
+    /**
+     * @return Number of samples taken
+     */
+    uint32_t getSampleCount() const;
+
+    /**
+     * @return Number of samples dropped because the queue was full
+     */
+    uint32_t getOverrunCount() const;
+
+    /**
+     * @return Number of samples dropped because the SPI read failed
+     */
+    uint32_t getErrorCount() const;
+
+private:
+    /** ADC to sample */
+    MAX22530& max;
+    /** Channels to read on each sample */
+    uint8_t mask;
+    /** Timer pacing the samples, nullptr when paced by the data ready pin */
+    DEV::Timer* timer = nullptr;
+    /** Whether samples are being taken */
+    volatile bool running = false;
+    /** Time sampling was last started */
+    uint32_t startTime = 0;
+    /** Samples waiting to be popped */
+    SPSCQueue<TimedSample, QUEUE_SIZE> queue;
+    /** Number of samples taken */
+    volatile uint32_t sampleCount = 0;
+    /** Number of failed SPI reads */
+    volatile uint32_t errorCount = 0;
+
+    /** Sampler paced by the timer, the timer interrupt carries no context */
+    static MAX22530Sampler* timerSampler;
+
+    /**
+     * Timer interrupt handler
+     *
+     * @param[in] htim Timer that fired
+     */
+    static void timerIRQHandler(void* htim);
+
+    /**
+     * Data ready interrupt handler
+     *
+     * @param[in] pin GPIO that triggered the interrupt
+     * @param[in] priv The MAX22530Sampler
+     */
+    static void dataReadyIRQHandler(IO::GPIO* pin, void* priv);
+};
+
+}// namespace PreCharge
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef USE_HAL_DRIVER
+    #include <HALf3/stm32f3xx.h>
+#endif
+
+namespace PreCharge {
+
+/**
+ * Free running counter for timing short sections of code, such as interrupt
+ * handlers, below the resolution of time::millis().
+ *
+ * On target this is the Cortex-M4 DWT cycle counter, so one tick is one CPU
+ * cycle. On the host build a tick is one nanosecond of the steady clock and
+ * now() is provided by sim/src/CycleCounter.cpp.
+ */
+class CycleCounter {
+public:
+    /**
+     * Starts the counter. Must be called once before now() is used.
+     */
+    static void init() {
+#ifdef USE_HAL_DRIVER
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    }
+
+    /**
+     * Gets the current count. Wraps, so only the difference between two
+     * readings is meaningful.
+     *
+     * @return Current count in ticks
+     */
+#ifdef USE_HAL_DRIVER
+    static uint32_t now() {
+        return DWT->CYCCNT;
+    }
+#else
+    static uint32_t now();
+#endif
+
+    /**
+     * Converts a number of ticks to nanoseconds
+     *
+     * @param[in] ticks Difference between two now() readings
+     * @return Duration in nanoseconds
+     */
+    static uint32_t toNanoseconds(uint32_t ticks) {
+#ifdef USE_HAL_DRIVER
+        return static_cast<uint32_t>(static_cast<uint64_t>(ticks) * 1000000000 / SystemCoreClock);
+#else
+        return ticks;
+#endif
+    }
+};
+
+}// namespace PreCharge
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <PreCharge/utils/CycleCounter.hpp>
+
+#include <cstdint>
+
+namespace PreCharge {
+
+/**
+ * Execution time statistics of a section of code, in CycleCounter ticks.
+ * The fields are plain 32 bit values so they can be linked straight into the
+ * object dictionary, see CYCLE_STATS_LINK_21XX.
+ */
+struct CycleStats {
+    /** Number of times the section ran */
+    uint32_t calls;
+    /** Shortest run */
+    uint32_t min;
+    /** Longest run */
+    uint32_t max;
+    /** Running average, each run weighted 1/16 so it needs no divide */
+    uint32_t avg;
+
+    /**
+     * Adds a run of the section
+     *
+     * @param[in] ticks Duration of the run, the difference of two CycleCounter::now() readings
+     */
+    void record(uint32_t ticks) {
+        if (calls == 0) {
+            min = ticks;
+            max = ticks;
+            avg = ticks;
+        } else {
+            min = ticks < min ? ticks : min;
+            max = ticks > max ? ticks : max;
+            avg = static_cast<uint32_t>(static_cast<int32_t>(avg) + ((static_cast<int32_t>(ticks) - static_cast<int32_t>(avg)) >> 4));
+        }
+        calls++;
+    }
+};
+
+}// namespace PreCharge
+
+/**
+ * Object dictionary entries exposing a CycleStats read only over SDO as
+ * 0x2100 + x, sub-index 1 to 4 holding calls, min, max and avg.
+ *
+ * @param x Offset of the entry from 0x2100
+ * @param stats The CycleStats to link
+ */
+#define CYCLE_STATS_LINK_21XX(x, stats) \
+    {CO_KEY(0x2100 + x, 0, CO_OBJ_D___R_), CO_TUNSIGNED8, (CO_DATA) (0x04)}, \
+    {CO_KEY(0x2100 + x, 1, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&(stats).calls)}, \
+    {CO_KEY(0x2100 + x, 2, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&(stats).min)}, \
+    {CO_KEY(0x2100 + x, 3, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&(stats).max)}, \
+    {CO_KEY(0x2100 + x, 4, CO_OBJ_____R_), CO_TUNSIGNED32, (CO_DATA) (&(stats).avg)}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace PreCharge {
+
+/**
+ * Lock-free ring buffer for handing items from exactly one producer to
+ * exactly one consumer, typically an interrupt handler and the main loop.
+ * Neither side ever blocks or disables interrupts; a push to a full queue
+ * is dropped and counted instead. The most items ever held is tracked as
+ * well, so the queue can be sized from what it actually saw.
+ *
+ * The head and tail indices run freely and are masked on access, so SIZE
+ * must be a power of two.
+ *
+ * @tparam T Type of the items, copied in and out
+ * @tparam SIZE Capacity of the queue, a power of two
+ */
+template<typename T, size_t SIZE>
+class SPSCQueue {
+    static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "SPSCQueue size must be a power of two");
+
+public:
+    /**
+     * Counters of the queue, only written by the producer
+     */
+    struct Stats {
+        /** Items dropped because the queue was full */
+        uint32_t overruns;
+        /** Most items the queue has held at once */
+        uint32_t highWater;
+    };
+
+    /**
+     * Adds an item to the queue. Must only be called by the producer.
+     *
+     * @param[in] item Item to add
+     * @return false if the queue was full and the item was dropped
+     */
+    bool push(const T& item) {
+        uint32_t currentHead = head.load(std::memory_order_relaxed);
+        uint32_t depth = currentHead - tail.load(std::memory_order_acquire);
+        if (depth == SIZE) {
+            stats.overruns++;
+            return false;
+        }
+
+        buffer[currentHead & MASK] = item;
+        head.store(currentHead + 1, std::memory_order_release);
+        if (depth + 1 > stats.highWater) {
+            stats.highWater = depth + 1;
+        }
+        return true;
+    }
+
+    /**
+     * Removes the oldest item from the queue. Must only be called by the
+     * consumer.
+     *
+     * @param[out] item Item removed from the queue
+     * @return false if the queue was empty
+     */
+    bool pop(T& item) {
+        uint32_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = buffer[currentTail & MASK];
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @return Number of items in the queue
+     */
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return true if the queue holds no items
+     */
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @return Number of items dropped because the queue was full
+     */
+    uint32_t getOverrunCount() const {
+        return stats.overruns;
+    }
+
+    /**
+     * @return Overrun and high water counters
+     */
+    const Stats& getStats() const {
+        return stats;
+    }
+
+private:
+    static constexpr uint32_t MASK = SIZE - 1;
+
+    /** Storage for the items */
+    T buffer[SIZE];
+    /** Index of the next item to write, only written by the producer */
+    std::atomic<uint32_t> head{0};
+    /** Index of the next item to read, only written by the consumer */
+    std::atomic<uint32_t> tail{0};
+    /** Counters, only written by the producer */
+    Stats stats = {};
+};
+
+}// namespace PreCharge
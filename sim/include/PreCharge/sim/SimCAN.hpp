@@ -0,0 +1,135 @@
+#pragma once
+
+#include <EVT/io/CAN.hpp>
+#include <cstdint>
+
+namespace IO = EVT::core::IO;
+
+namespace PreCharge::sim {
+
+/**
+ * Host-side stand-in for the CAN peripheral.
+ *
+ * Transmitted frames are counted and handed to an optional transmit hook so
+ * that bus devices (SIM100, motor controller, ...) can be modelled. Frames
+ * injected with inject() go through the registered IRQ handler exactly as
+ * they would on target; frames that end up in addCANMessage() can then be
+ * read back with receive().
+ */
+class SimCAN : public IO::CAN {
+public:
+    /** Number of frames that can be buffered for receive() */
+    static constexpr uint8_t RX_QUEUE_SIZE = 32;
+
+    /**
+     * Hook called on every transmitted frame
+     *
+     * @param[in] message The frame that was put on the simulated bus
+     * @param[in] priv Private data registered with the hook
+     */
+    using TransmitHook = void (*)(IO::CANMessage& message, void* priv);
+
+    SimCAN();
+
+    CANStatus connect(bool autoBusOff = false) override;
+
+    CANStatus disconnect() override;
+
+    CANStatus transmit(IO::CANMessage& message) override;
+
+    CANStatus receive(IO::CANMessage* message, bool blocking = false) override;
+
+    CANStatus addCANFilter(uint16_t filterExplicitId, uint16_t filterMask, uint8_t filterBank) override;
+
+    CANStatus enableEmergencyFilter(uint32_t state) override;
+
+    /**
+     * Deliver a frame from the simulated bus. Goes through the registered IRQ
+     * handler if there is one, otherwise it is queued for receive().
+     *
+     * @param[in] message The frame to deliver
+     */
+    void inject(IO::CANMessage& message);
+
+    /**
+     * Queue a frame to be returned by receive(). Mirrors
+     * CANf3xx::addCANMessage() so the same IRQ handlers can be used.
+     *
+     * @param[in] message The frame to queue
+     * @return false if the receive queue was full and the frame was dropped
+     */
+    bool addCANMessage(IO::CANMessage& message);
+
+    /**
+     * Install a hook that sees every transmitted frame
+     *
+     * @param[in] hook Function to call, nullptr to remove
+     * @param[in] priv Private data handed to the hook
+     */
+    void setTransmitHook(TransmitHook hook, void* priv);
+
+    /**
+     * @return Number of frames transmitted since construction
+     */
+    uint32_t getTransmitCount() const;
+
+    /**
+     * Get the number of transmitted frames with a specific ID
+     *
+     * @param[in] id CAN ID to count
+     * @return Number of transmitted frames with that ID
+     */
+    uint32_t getTransmitCount(uint32_t id) const;
+
+    /**
+     * Get the most recent transmitted frame with a specific ID
+     *
+     * @param[in] id CAN ID to look up
+     * @param[out] message The last frame sent with that ID
+     * @return false if no frame with that ID was transmitted
+     */
+    bool getLastFrame(uint32_t id, IO::CANMessage* message) const;
+
+    /**
+     * Clear all transmit counters
+     */
+    void resetCounters();
+
+    /**
+     * Limit how many frames transmit() takes per millisecond, as the bus
+     * and the three transmit mailboxes would. Frames past the limit are
+     * refused with TIMEOUT and not counted.
+     *
+     * @param[in] framesPerMs Frames taken per millisecond, 0 for no limit
+     */
+    void setTransmitLimit(uint8_t framesPerMs);
+
+    /**
+     * @return Number of frames refused by the transmit limit
+     */
+    uint32_t getRefusedCount() const;
+
+private:
+    /** Number of distinct IDs tracked by the per-ID transmit counters */
+    static constexpr uint8_t MAX_TRACKED_IDS = 16;
+
+    IO::CANMessage rxQueue[RX_QUEUE_SIZE];
+    uint8_t rxHead = 0;
+    uint8_t rxCount = 0;
+
+    TransmitHook transmitHook = nullptr;
+    void* transmitHookPriv = nullptr;
+
+    uint32_t transmitCount = 0;
+    uint8_t transmitLimit = 0;
+    /** Millisecond the frames in windowCount were transmitted in */
+    uint32_t windowStart = 0;
+    uint8_t windowCount = 0;
+    uint32_t refusedCount = 0;
+    uint32_t trackedIds[MAX_TRACKED_IDS] = {};
+    uint32_t trackedCounts[MAX_TRACKED_IDS] = {};
+    IO::CANMessage trackedFrames[MAX_TRACKED_IDS];
+    uint8_t numTrackedIds = 0;
+};
+
+}// namespace PreCharge::sim
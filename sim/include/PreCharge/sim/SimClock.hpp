@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+
+namespace PreCharge::sim {
+
+/**
+ * Time source behind EVT::core::time::millis() and wait() in the host build.
+ *
+ * In REAL mode time follows the host's monotonic clock and wait() sleeps. In
+ * VIRTUAL mode time only moves when something waits or the simulation
+ * advances it, so every wait() returns immediately with the clock moved
+ * straight to its deadline. This lets state machine timeouts of several
+ * seconds be simulated in microseconds, deterministically.
+ */
+class SimClock {
+public:
+    enum class Mode {
+        REAL = 0u,
+        VIRTUAL = 1u
+    };
+
+    /** Maximum number of pending deadlines that can be registered */
+    static constexpr uint8_t MAX_DEADLINES = 16;
+
+    /** Maximum number of periodic callbacks that can be registered */
+    static constexpr uint8_t MAX_PERIODIC = 4;
+
+    /**
+     * Callback run by advance() at a fixed virtual time interval
+     *
+     * @param[in] priv Private data passed to addPeriodic()
+     */
+    using PeriodicHandler = void (*)(void* priv);
+
+    /**
+     * Select the time source. Switching to VIRTUAL keeps the current time so
+     * millis() stays monotonic.
+     *
+     * @param[in] mode The new time source
+     */
+    static void setMode(Mode mode);
+
+    /**
+     * @return The active time source
+     */
+    static Mode getMode();
+
+    /**
+     * @return Current time in milliseconds
+     */
+    static uint32_t now();
+
+    /**
+     * Wait for the given time. Sleeps in REAL mode and jumps the clock in
+     * VIRTUAL mode.
+     *
+     * @param[in] ms Time to wait in milliseconds
+     */
+    static void wait(uint32_t ms);
+
+    /**
+     * Move virtual time forward, running any periodic callbacks that fall due
+     * on the way in time order. Has no effect in REAL mode.
+     *
+     * @param[in] ms Time to advance in milliseconds
+     */
+    static void advance(uint32_t ms);
+
+    /**
+     * Register a point in time the simulation cares about, e.g. the end of a
+     * state machine timeout. Deadlines in the past are ignored.
+     *
+     * @param[in] deadline Absolute time of the deadline in milliseconds
+     * @return false if the deadline table is full
+     */
+    static bool addDeadline(uint32_t deadline);
+
+    /**
+     * Jump virtual time to the earliest registered deadline and remove it.
+     *
+     * @return false if there was no pending deadline or not in VIRTUAL mode
+     */
+    static bool advanceToNextDeadline();
+
+    /**
+     * Register a callback to run every period milliseconds of virtual time,
+     * standing in for a hardware timer interrupt. Only runs in VIRTUAL mode.
+     *
+     * @param[in] period Interval between calls in milliseconds, at least 1
+     * @param[in] handler Callback to run
+     * @param[in] priv Private data passed to the callback
+     * @return false if the periodic table is full
+     */
+    static bool addPeriodic(uint32_t period, PeriodicHandler handler, void* priv);
+
+    /**
+     * Remove a callback registered with addPeriodic()
+     *
+     * @param[in] handler Callback to remove
+     * @param[in] priv Private data it was registered with
+     */
+    static void removePeriodic(PeriodicHandler handler, void* priv);
+};
+
+}// namespace PreCharge::sim
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <EVT/io/GPIO.hpp>
+#include <cstdint>
+
+namespace IO = EVT::core::IO;
+
+namespace PreCharge::sim {
+
+/**
+ * Host-side stand-in for an MCU GPIO pin.
+ *
+ * Outputs simply latch the last written state. Inputs are driven by the
+ * simulation through setInput(), which also fires any registered IRQ handler
+ * on a matching edge, the same way the EXTI line would on target.
+ */
+class SimGPIO : public IO::GPIO {
+public:
+    /**
+     * Create a simulated pin
+     *
+     * @param[in] pin The pin being simulated, only used for identification
+     * @param[in] direction Initial direction of the pin
+     */
+    explicit SimGPIO(IO::Pin pin, Direction direction = Direction::OUTPUT);
+
+    void setDirection(Direction direction) override;
+
+    void writePin(State state) override;
+
+    State readPin() override;
+
+    void registerIRQ(TriggerEdge edge, void (*irqHandler)(IO::GPIO* pin, void* priv), void* priv) override;
+
+    /**
+     * Drive the pin from the simulation. Fires the registered IRQ handler
+     * if the change matches the registered trigger edge.
+     *
+     * @param[in] state The new state of the pin
+     */
+    void setInput(State state);
+
+    /**
+     * @return Number of readPin() calls since construction
+     */
+    uint32_t getReadCount() const;
+
+    /**
+     * @return Number of writePin() calls since construction
+     */
+    uint32_t getWriteCount() const;
+
+private:
+    /** Current level of the pin */
+    State state = State::LOW;
+    /** Edge the registered IRQ handler should fire on */
+    TriggerEdge edge = TriggerEdge::RISING_FALLING;
+    /** Registered IRQ handler, nullptr if none */
+    void (*irqHandler)(IO::GPIO* pin, void* priv) = nullptr;
+    /** Private data to hand back to the IRQ handler */
+    void* irqPriv = nullptr;
+
+    uint32_t readCount = 0;
+    uint32_t writeCount = 0;
+};
+
+}// namespace PreCharge::sim
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <PreCharge/sim/SimGPIO.hpp>
+#include <PreCharge/sim/SimSPI.hpp>
+#include <cstdint>
+
+namespace PreCharge::sim {
+
+/**
+ * Model of the high voltage bus as seen by the MAX22530.
+ *
+ * The motor controller side of the bus charges through the precharge
+ * resistor while PC_CTL is high and bleeds down through the discharge
+ * resistor while DC_CTL is high. Register 0x01 reads the motor controller
+ * side and register 0x02 the pack, in raw ADC counts.
+ */
+class SimHVBus {
+public:
+    /**
+     * @param[in] pc Precharge relay output
+     * @param[in] dc Discharge relay output
+     * @param[in] packCounts Pack voltage in raw ADC counts
+     * @param[in] tau RC time constant of the precharge circuit in seconds
+     */
+    SimHVBus(SimGPIO& pc, SimGPIO& dc, uint16_t packCounts, double tau);
+
+    /**
+     * Make this model supply the register values of the given SPI bus
+     *
+     * @param[in] spi The simulated SPI bus the MAX22530 is on
+     */
+    void attach(SimSPI& spi);
+
+    /**
+     * @param[in] counts New pack voltage in raw ADC counts
+     */
+    void setPackCounts(uint16_t counts);
+
+    /**
+     * @return Motor controller side voltage in raw ADC counts
+     */
+    uint16_t getOutputCounts();
+
+private:
+    SimGPIO& pc;
+    SimGPIO& dc;
+    uint16_t packCounts;
+    double tau;
+    double outputCounts = 0;
+    uint32_t lastUpdate;
+
+    /** Integrate the bus voltage up to the current time */
+    void update();
+
+    static uint16_t readHook(uint8_t address, void* priv);
+};
+
+}// namespace PreCharge::sim
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <PreCharge/sim/SimCAN.hpp>
+#include <cstdint>
+
+namespace PreCharge::sim {
+
+/**
+ * Model of the SIM100 ground fault detector. Answers every request with the
+ * echoed command byte on the reply ID, followed by a zeroed payload (no
+ * isolation fault).
+ */
+class SimSIM100 {
+public:
+    /** CAN ID the SIM100 listens on, see GFDB::GFDB_ID */
+    static constexpr uint32_t REQUEST_ID = 0xA100101;
+    /** CAN ID the SIM100 replies on */
+    static constexpr uint32_t REPLY_ID = REQUEST_ID - 1;
+
+    /**
+     * Make this model answer requests transmitted on the given bus
+     *
+     * @param[in] can The simulated CAN bus the GFDB is on
+     */
+    void attach(SimCAN& can);
+
+    /**
+     * @param[in] isoState Isolation state reported in the ISO_STATE reply
+     */
+    void setIsolationState(uint8_t isoState);
+
+    /**
+     * @param[in] respond false to stop answering, used to simulate timeouts
+     */
+    void setResponding(bool respond);
+
+    /**
+     * @return Number of requests received
+     */
+    uint32_t getRequestCount() const;
+
+private:
+    SimCAN* can = nullptr;
+    uint8_t isoState = 0;
+    bool responding = true;
+    uint32_t requestCount = 0;
+
+    static void transmitHook(IO::CANMessage& message, void* priv);
+};
+
+}// namespace PreCharge::sim
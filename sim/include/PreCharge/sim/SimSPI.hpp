@@ -0,0 +1,96 @@
+#pragma once
+
+#include <EVT/io/SPI.hpp>
+#include <cstdint>
+
+namespace IO = EVT::core::IO;
+
+namespace PreCharge::sim {
+
+/**
+ * Host-side stand-in for an SPI bus with a single register-mapped device
+ * behind it.
+ *
+ * The device follows the MAX22530 framing: the first byte of a transaction
+ * carries the register address in bits 7:2, the read/write flag in bit 1 and
+ * the burst flag in bit 0. Registers are 16 bits and are shifted out MSB
+ * first. In burst mode reads continue into the following registers until
+ * chip select is released.
+ */
+class SimSPI : public IO::SPI {
+public:
+    /** Number of addressable registers (6 address bits) */
+    static constexpr uint8_t NUM_REGISTERS = 64;
+
+    /**
+     * Hook used to compute a register value at the time it is read, lets a
+     * plant model feed live values into the bus.
+     *
+     * @param[in] address Register address being read
+     * @param[in] priv Private data registered with the hook
+     * @return The value of the register
+     */
+    using ReadHook = uint16_t (*)(uint8_t address, void* priv);
+
+    SimSPI();
+
+    void configureSPI(uint32_t baudRate, uint8_t mode, uint8_t order) override;
+
+    SPIStatus startTransmission(uint8_t device) override;
+
+    SPIStatus endTransmission(uint8_t device) override;
+
+    SPIStatus write(uint8_t byte) override;
+
+    SPIStatus read(uint8_t* out) override;
+
+    SPIStatus write(uint8_t* bytes, uint8_t length) override;
+
+    SPIStatus read(uint8_t* bytes, uint8_t length) override;
+
+    /**
+     * Set the static value of a register
+     *
+     * @param[in] address Register address
+     * @param[in] value Value the register will read back as
+     */
+    void setRegister(uint8_t address, uint16_t value);
+
+    /**
+     * Install a hook that supplies register values on every read, takes
+     * priority over setRegister()
+     *
+     * @param[in] hook Function computing register values, nullptr to remove
+     * @param[in] priv Private data handed to the hook
+     */
+    void setReadHook(ReadHook hook, void* priv);
+
+    /**
+     * @return Number of chip-select transactions since construction
+     */
+    uint32_t getTransactionCount() const;
+
+private:
+    uint16_t registers[NUM_REGISTERS] = {};
+    ReadHook readHook = nullptr;
+    void* readHookPriv = nullptr;
+
+    /** Whether chip select is currently asserted */
+    bool selected = false;
+    /** Whether the command byte of the current transaction was received */
+    bool addressed = false;
+    /** Whether the current transaction is a burst read */
+    bool burst = false;
+    /** Register currently being shifted out */
+    uint8_t address = 0;
+    /** Byte of the current register being shifted out, 0 = MSB */
+    uint8_t byteIndex = 0;
+    /** Value of the register currently being shifted out */
+    uint16_t shiftRegister = 0;
+
+    uint32_t transactionCount = 0;
+
+    uint16_t registerValue(uint8_t reg);
+};
+
+}// namespace PreCharge::sim
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <EVT/dev/Timer.hpp>
+#include <cstdint>
+
+namespace DEV = EVT::core::DEV;
+
+namespace PreCharge::sim {
+
+/**
+ * Host-side stand-in for a hardware timer. The interrupt handler is run by
+ * SimClock as virtual time advances, so it only fires in VIRTUAL mode.
+ */
+class SimTimer : public DEV::Timer {
+public:
+    /**
+     * @param[in] clockPeriod Interval between interrupts in milliseconds
+     */
+    explicit SimTimer(uint32_t clockPeriod);
+
+    void startTimer(void (*irqHandler)(void* htim)) override;
+
+    void startTimer() override;
+
+    void stopTimer() override;
+
+    void reloadTimer() override;
+
+    void setPeriod(uint32_t clockPeriod) override;
+
+private:
+    /** Interval between interrupts in milliseconds */
+    uint32_t clockPeriod;
+    /** Handler run on every interrupt */
+    void (*irqHandler)(void* htim) = nullptr;
+    /** Whether the timer is registered with SimClock */
+    bool running = false;
+
+    /**
+     * SimClock callback standing in for the timer interrupt
+     *
+     * @param[in] priv The SimTimer
+     */
+    static void tick(void* priv);
+};
+
+}// namespace PreCharge::sim
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <EVT/io/UART.hpp>
+#include <cstdio>
+
+namespace IO = EVT::core::IO;
+
+namespace PreCharge::sim {
+
+/**
+ * Host-side stand-in for the UART. Output goes to a stdio stream and input
+ * is read from stdin, which is enough for the logger and the manual targets.
+ */
+class SimUART : public IO::UART {
+public:
+    /**
+     * @param[in] out Stream all output is written to
+     */
+    explicit SimUART(FILE* out = stdout);
+
+    void setBaudrate(uint32_t baudrate) override;
+
+    void setFormat(WordLength wordLength = WordLength::EIGHT, Parity parity = Parity::NONE,
+                   NumStopBits numStopBits = NumStopBits::ONE) override;
+
+    void sendBreak() override;
+
+    bool isReadable() override;
+
+    bool isWritable() override;
+
+    void putc(char c) override;
+
+    void puts(const char* s) override;
+
+    char getc() override;
+
+    void printf(const char* format, ...) override;
+
+    char* gets(char* buf, size_t size) override;
+
+    void write(uint8_t byte) override;
+
+    uint8_t read() override;
+
+    void writeBytes(uint8_t* bytes, size_t size) override;
+
+    void readBytes(uint8_t* bytes, size_t size) override;
+
+private:
+    FILE* out;
+};
+
+}// namespace PreCharge::sim
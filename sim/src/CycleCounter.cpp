@@ -0,0 +1,17 @@
+/**
+ * Host implementation of PreCharge::CycleCounter, counting nanoseconds of the
+ * steady clock in place of the DWT cycle counter.
+ */
+
+#include <PreCharge/utils/CycleCounter.hpp>
+
+#include <chrono>
+
+namespace PreCharge {
+
+uint32_t CycleCounter::now() {
+    auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+}// namespace PreCharge
@@ -0,0 +1,133 @@
+#include <PreCharge/sim/SimCAN.hpp>
+
+#include <EVT/utils/time.hpp>
+
+namespace PreCharge::sim {
+
+SimCAN::SimCAN() : IO::CAN(IO::Pin::PA_12, IO::Pin::PA_11, false) {}
+
+IO::CAN::CANStatus SimCAN::connect(bool autoBusOff) {
+    return CANStatus::OK;
+}
+
+IO::CAN::CANStatus SimCAN::disconnect() {
+    return CANStatus::OK;
+}
+
+IO::CAN::CANStatus SimCAN::transmit(IO::CANMessage& message) {
+    if (transmitLimit != 0) {
+        uint32_t now = EVT::core::time::millis();
+        if (now != windowStart) {
+            windowStart = now;
+            windowCount = 0;
+        }
+        if (windowCount == transmitLimit) {
+            refusedCount++;
+            return CANStatus::TIMEOUT;
+        }
+        windowCount++;
+    }
+    transmitCount++;
+
+    uint32_t id = message.getId();
+    uint8_t i = 0;
+    while (i < numTrackedIds && trackedIds[i] != id) {
+        i++;
+    }
+    if (i == numTrackedIds && numTrackedIds < MAX_TRACKED_IDS) {
+        trackedIds[numTrackedIds++] = id;
+    }
+    if (i < numTrackedIds) {
+        trackedCounts[i]++;
+        trackedFrames[i] = message;
+    }
+
+    if (transmitHook != nullptr) {
+        transmitHook(message, transmitHookPriv);
+    }
+    return CANStatus::OK;
+}
+
+IO::CAN::CANStatus SimCAN::receive(IO::CANMessage* message, bool blocking) {
+    // Nothing else can put frames on the simulated bus while we would be
+    // blocked, so blocking and non-blocking receives behave the same
+    if (rxCount == 0) {
+        return CANStatus::TIMEOUT;
+    }
+
+    *message = rxQueue[rxHead];
+    rxHead = (rxHead + 1) % RX_QUEUE_SIZE;
+    rxCount--;
+    return CANStatus::OK;
+}
+
+IO::CAN::CANStatus SimCAN::addCANFilter(uint16_t filterExplicitId, uint16_t filterMask, uint8_t filterBank) {
+    return CANStatus::OK;
+}
+
+IO::CAN::CANStatus SimCAN::enableEmergencyFilter(uint32_t state) {
+    return CANStatus::OK;
+}
+
+void SimCAN::inject(IO::CANMessage& message) {
+    if (!triggerIRQ(message)) {
+        addCANMessage(message);
+    }
+}
+
+bool SimCAN::addCANMessage(IO::CANMessage& message) {
+    if (rxCount == RX_QUEUE_SIZE) {
+        return false;
+    }
+
+    rxQueue[(rxHead + rxCount) % RX_QUEUE_SIZE] = message;
+    rxCount++;
+    return true;
+}
+
+void SimCAN::setTransmitHook(TransmitHook hook, void* priv) {
+    transmitHook = hook;
+    transmitHookPriv = priv;
+}
+
+uint32_t SimCAN::getTransmitCount() const {
+    return transmitCount;
+}
+
+uint32_t SimCAN::getTransmitCount(uint32_t id) const {
+    for (uint8_t i = 0; i < numTrackedIds; i++) {
+        if (trackedIds[i] == id) {
+            return trackedCounts[i];
+        }
+    }
+    return 0;
+}
+
+bool SimCAN::getLastFrame(uint32_t id, IO::CANMessage* message) const {
+    for (uint8_t i = 0; i < numTrackedIds; i++) {
+        if (trackedIds[i] == id) {
+            *message = trackedFrames[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void SimCAN::setTransmitLimit(uint8_t framesPerMs) {
+    transmitLimit = framesPerMs;
+    windowCount = 0;
+}
+
+uint32_t SimCAN::getRefusedCount() const {
+    return refusedCount;
+}
+
+void SimCAN::resetCounters() {
+    transmitCount = 0;
+    refusedCount = 0;
+    for (uint8_t i = 0; i < numTrackedIds; i++) {
+        trackedCounts[i] = 0;
+    }
+}
+
+}// namespace PreCharge::sim
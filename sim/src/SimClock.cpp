@@ -0,0 +1,138 @@
+#include <PreCharge/sim/SimClock.hpp>
+
+#include <chrono>
+#include <thread>
+
+namespace PreCharge::sim {
+
+namespace {
+const auto START = std::chrono::steady_clock::now();
+
+SimClock::Mode mode = SimClock::Mode::REAL;
+uint32_t virtualNow = 0;
+
+uint32_t deadlines[SimClock::MAX_DEADLINES];
+uint8_t numDeadlines = 0;
+
+struct Periodic {
+    uint32_t period;
+    uint32_t next;
+    SimClock::PeriodicHandler handler;
+    void* priv;
+};
+
+Periodic periodics[SimClock::MAX_PERIODIC];
+uint8_t numPeriodics = 0;
+
+uint32_t realNow() {
+    auto elapsed = std::chrono::steady_clock::now() - START;
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+}// namespace
+
+void SimClock::setMode(Mode newMode) {
+    if (newMode == mode) {
+        return;
+    }
+    if (newMode == Mode::VIRTUAL) {
+        virtualNow = realNow();
+    }
+    mode = newMode;
+}
+
+SimClock::Mode SimClock::getMode() {
+    return mode;
+}
+
+uint32_t SimClock::now() {
+    return mode == Mode::VIRTUAL ? virtualNow : realNow();
+}
+
+void SimClock::wait(uint32_t ms) {
+    if (mode == Mode::VIRTUAL) {
+        advance(ms);
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+void SimClock::advance(uint32_t ms) {
+    if (mode != Mode::VIRTUAL) {
+        return;
+    }
+
+    // Step through the periodic callbacks due before the target in time
+    // order. The table is searched again after every call because a callback
+    // may remove itself.
+    uint32_t target = virtualNow + ms;
+    while (numPeriodics > 0) {
+        uint8_t next = 0;
+        for (uint8_t i = 1; i < numPeriodics; i++) {
+            if (periodics[i].next - virtualNow < periodics[next].next - virtualNow) {
+                next = i;
+            }
+        }
+
+        Periodic& periodic = periodics[next];
+        if (periodic.next - virtualNow > target - virtualNow) {
+            break;
+        }
+        virtualNow = periodic.next;
+        periodic.next += periodic.period;
+        periodic.handler(periodic.priv);
+    }
+    virtualNow = target;
+}
+
+bool SimClock::addDeadline(uint32_t deadline) {
+    if (static_cast<int32_t>(deadline - now()) <= 0) {
+        return true;
+    }
+    if (numDeadlines == MAX_DEADLINES) {
+        return false;
+    }
+    deadlines[numDeadlines++] = deadline;
+    return true;
+}
+
+bool SimClock::advanceToNextDeadline() {
+    if (mode != Mode::VIRTUAL || numDeadlines == 0) {
+        return false;
+    }
+
+    // Deadlines are compared relative to now so the search survives the
+    // 32 bit millisecond counter wrapping
+    uint8_t next = 0;
+    for (uint8_t i = 1; i < numDeadlines; i++) {
+        if (deadlines[i] - virtualNow < deadlines[next] - virtualNow) {
+            next = i;
+        }
+    }
+
+    uint32_t deadline = deadlines[next];
+    deadlines[next] = deadlines[--numDeadlines];
+
+    if (static_cast<int32_t>(deadline - virtualNow) > 0) {
+        advance(deadline - virtualNow);
+    }
+    return true;
+}
+
+bool SimClock::addPeriodic(uint32_t period, PeriodicHandler handler, void* priv) {
+    if (numPeriodics == MAX_PERIODIC || period == 0) {
+        return false;
+    }
+    periodics[numPeriodics++] = {period, now() + period, handler, priv};
+    return true;
+}
+
+void SimClock::removePeriodic(PeriodicHandler handler, void* priv) {
+    for (uint8_t i = 0; i < numPeriodics; i++) {
+        if (periodics[i].handler == handler && periodics[i].priv == priv) {
+            periodics[i] = periodics[--numPeriodics];
+            return;
+        }
+    }
+}
+
+}// namespace PreCharge::sim
@@ -0,0 +1,51 @@
+#include <PreCharge/sim/SimGPIO.hpp>
+
+namespace PreCharge::sim {
+
+SimGPIO::SimGPIO(IO::Pin pin, Direction direction) : IO::GPIO(pin, direction) {}
+
+void SimGPIO::setDirection(Direction direction) {
+    this->direction = direction;
+}
+
+void SimGPIO::writePin(State state) {
+    writeCount++;
+    this->state = state;
+}
+
+IO::GPIO::State SimGPIO::readPin() {
+    readCount++;
+    return state;
+}
+
+void SimGPIO::registerIRQ(TriggerEdge edge, void (*irqHandler)(IO::GPIO* pin, void* priv), void* priv) {
+    this->edge = edge;
+    this->irqHandler = irqHandler;
+    this->irqPriv = priv;
+}
+
+void SimGPIO::setInput(State state) {
+    if (state == this->state) {
+        return;
+    }
+    this->state = state;
+
+    if (irqHandler == nullptr) {
+        return;
+    }
+
+    bool rising = state == State::HIGH;
+    if ((rising && edge != TriggerEdge::FALLING) || (!rising && edge != TriggerEdge::RISING)) {
+        irqHandler(this, irqPriv);
+    }
+}
+
+uint32_t SimGPIO::getReadCount() const {
+    return readCount;
+}
+
+uint32_t SimGPIO::getWriteCount() const {
+    return writeCount;
+}
+
+}// namespace PreCharge::sim
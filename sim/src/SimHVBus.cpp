@@ -0,0 +1,47 @@
+#include <PreCharge/sim/SimHVBus.hpp>
+
+#include <EVT/utils/time.hpp>
+#include <cmath>
+
+namespace PreCharge::sim {
+
+SimHVBus::SimHVBus(SimGPIO& pc, SimGPIO& dc, uint16_t packCounts, double tau)
+    : pc(pc), dc(dc), packCounts(packCounts), tau(tau), lastUpdate(EVT::core::time::millis()) {}
+
+void SimHVBus::attach(SimSPI& spi) {
+    spi.setReadHook(readHook, this);
+}
+
+void SimHVBus::setPackCounts(uint16_t counts) {
+    update();
+    packCounts = counts;
+}
+
+uint16_t SimHVBus::getOutputCounts() {
+    update();
+    return static_cast<uint16_t>(outputCounts);
+}
+
+void SimHVBus::update() {
+    uint32_t now = EVT::core::time::millis();
+    double dt = (now - lastUpdate) / 1000.0;
+    lastUpdate = now;
+
+    if (pc.readPin() == IO::GPIO::State::HIGH) {
+        outputCounts += (packCounts - outputCounts) * (1 - std::exp(-dt / tau));
+    } else if (dc.readPin() == IO::GPIO::State::HIGH) {
+        outputCounts -= outputCounts * (1 - std::exp(-dt / tau));
+    }
+}
+
+uint16_t SimHVBus::readHook(uint8_t address, void* priv) {
+    auto* bus = static_cast<SimHVBus*>(priv);
+
+    switch (address) {
+    case 0x01: return bus->getOutputCounts();
+    case 0x02: return bus->packCounts;
+    default: return 0;
+    }
+}
+
+}// namespace PreCharge::sim
@@ -0,0 +1,46 @@
+#include <PreCharge/sim/SimSIM100.hpp>
+
+namespace PreCharge::sim {
+
+/** Command byte of the isolation state request, see GFDB::ISO_STATE_REQ_CMD */
+constexpr uint8_t ISO_STATE_REQ_CMD = 0xE0;
+
+void SimSIM100::attach(SimCAN& can) {
+    this->can = &can;
+    can.setTransmitHook(transmitHook, this);
+}
+
+void SimSIM100::setIsolationState(uint8_t isoState) {
+    this->isoState = isoState;
+}
+
+void SimSIM100::setResponding(bool respond) {
+    responding = respond;
+}
+
+uint32_t SimSIM100::getRequestCount() const {
+    return requestCount;
+}
+
+void SimSIM100::transmitHook(IO::CANMessage& message, void* priv) {
+    auto* sim100 = static_cast<SimSIM100*>(priv);
+    if (!message.isCANExtended() || message.getId() != REQUEST_ID) {
+        return;
+    }
+
+    sim100->requestCount++;
+    if (!sim100->responding) {
+        return;
+    }
+
+    uint8_t command = message.getPayload()[0];
+    uint8_t payload[8] = {command};
+    if (command == ISO_STATE_REQ_CMD) {
+        payload[1] = sim100->isoState;
+    }
+
+    IO::CANMessage reply(REPLY_ID, 8, payload, true);
+    sim100->can->inject(reply);
+}
+
+}// namespace PreCharge::sim
@@ -0,0 +1,102 @@
+#include <PreCharge/sim/SimSPI.hpp>
+
+namespace PreCharge::sim {
+
+// The simulated bus has no chip select pins of its own, the device index
+// passed to start/endTransmission() is ignored
+SimSPI::SimSPI() : IO::SPI(nullptr, 0, IO::Pin::PA_5, IO::Pin::PA_7, IO::Pin::PA_6) {}
+
+void SimSPI::configureSPI(uint32_t baudRate, uint8_t mode, uint8_t order) {}
+
+IO::SPI::SPIStatus SimSPI::startTransmission(uint8_t device) {
+    selected = true;
+    addressed = false;
+    burst = false;
+    byteIndex = 0;
+    transactionCount++;
+    return SPIStatus::OK;
+}
+
+IO::SPI::SPIStatus SimSPI::endTransmission(uint8_t device) {
+    selected = false;
+    return SPIStatus::OK;
+}
+
+IO::SPI::SPIStatus SimSPI::write(uint8_t byte) {
+    if (!selected) {
+        return SPIStatus::ERROR;
+    }
+
+    // Only the command byte matters, register writes are not modelled
+    if (!addressed) {
+        address = (byte >> 2) % NUM_REGISTERS;
+        burst = byte & 0x01;
+        byteIndex = 0;
+        addressed = true;
+    }
+    return SPIStatus::OK;
+}
+
+IO::SPI::SPIStatus SimSPI::read(uint8_t* out) {
+    if (!selected || !addressed) {
+        return SPIStatus::ERROR;
+    }
+
+    // Latch the whole register on its first byte so a live value can't
+    // change between the two halves
+    if (byteIndex == 0) {
+        shiftRegister = registerValue(address);
+    }
+    *out = byteIndex == 0 ? shiftRegister >> 8 : shiftRegister & 0xFF;
+
+    byteIndex++;
+    if (byteIndex == 2) {
+        byteIndex = 0;
+        if (burst) {
+            address = (address + 1) % NUM_REGISTERS;
+        }
+    }
+    return SPIStatus::OK;
+}
+
+IO::SPI::SPIStatus SimSPI::write(uint8_t* bytes, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        SPIStatus status = write(bytes[i]);
+        if (status != SPIStatus::OK) {
+            return status;
+        }
+    }
+    return SPIStatus::OK;
+}
+
+IO::SPI::SPIStatus SimSPI::read(uint8_t* bytes, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        SPIStatus status = read(&bytes[i]);
+        if (status != SPIStatus::OK) {
+            return status;
+        }
+    }
+    return SPIStatus::OK;
+}
+
+void SimSPI::setRegister(uint8_t address, uint16_t value) {
+    registers[address % NUM_REGISTERS] = value;
+}
+
+void SimSPI::setReadHook(ReadHook hook, void* priv) {
+    readHook = hook;
+    readHookPriv = priv;
+}
+
+uint32_t SimSPI::getTransactionCount() const {
+    return transactionCount;
+}
+
+uint16_t SimSPI::registerValue(uint8_t reg) {
+    if (readHook != nullptr) {
+        return readHook(reg, readHookPriv);
+    }
+    return registers[reg];
+}
+
+}// namespace PreCharge::sim
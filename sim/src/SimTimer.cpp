@@ -0,0 +1,45 @@
+#include <PreCharge/sim/SimClock.hpp>
+#include <PreCharge/sim/SimTimer.hpp>
+
+namespace PreCharge::sim {
+
+SimTimer::SimTimer(uint32_t clockPeriod) : clockPeriod(clockPeriod) {}
+
+void SimTimer::startTimer(void (*irqHandler)(void* htim)) {
+    this->irqHandler = irqHandler;
+    startTimer();
+}
+
+void SimTimer::startTimer() {
+    if (!running) {
+        running = SimClock::addPeriodic(clockPeriod, tick, this);
+    }
+}
+
+void SimTimer::stopTimer() {
+    if (running) {
+        SimClock::removePeriodic(tick, this);
+        running = false;
+    }
+}
+
+void SimTimer::reloadTimer() {
+    stopTimer();
+    startTimer();
+}
+
+void SimTimer::setPeriod(uint32_t clockPeriod) {
+    this->clockPeriod = clockPeriod;
+    if (running) {
+        reloadTimer();
+    }
+}
+
+void SimTimer::tick(void* priv) {
+    auto* timer = static_cast<SimTimer*>(priv);
+    if (timer->irqHandler != nullptr) {
+        timer->irqHandler(timer);
+    }
+}
+
+}// namespace PreCharge::sim
@@ -0,0 +1,63 @@
+#include <PreCharge/sim/SimUART.hpp>
+
+#include <cstdarg>
+
+namespace PreCharge::sim {
+
+SimUART::SimUART(FILE* out) : IO::UART(IO::Pin::PB_6, IO::Pin::PB_7, 9600, true), out(out) {}
+
+void SimUART::setBaudrate(uint32_t baudrate) {}
+
+void SimUART::setFormat(WordLength wordLength, Parity parity, NumStopBits numStopBits) {}
+
+void SimUART::sendBreak() {}
+
+bool SimUART::isReadable() {
+    return true;
+}
+
+bool SimUART::isWritable() {
+    return true;
+}
+
+void SimUART::putc(char c) {
+    fputc(c, out);
+}
+
+void SimUART::puts(const char* s) {
+    fputs(s, out);
+}
+
+char SimUART::getc() {
+    int c = fgetc(stdin);
+    return c == EOF ? '\0' : static_cast<char>(c);
+}
+
+void SimUART::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(out, format, args);
+    va_end(args);
+}
+
+char* SimUART::gets(char* buf, size_t size) {
+    return fgets(buf, static_cast<int>(size), stdin);
+}
+
+void SimUART::write(uint8_t byte) {
+    fputc(byte, out);
+}
+
+uint8_t SimUART::read() {
+    return static_cast<uint8_t>(getc());
+}
+
+void SimUART::writeBytes(uint8_t* bytes, size_t size) {
+    fwrite(bytes, 1, size, out);
+}
+
+void SimUART::readBytes(uint8_t* bytes, size_t size) {
+    fread(bytes, 1, size, stdin);
+}
+
+}// namespace PreCharge::sim
@@ -0,0 +1,20 @@
+/**
+ * Host implementation of the EVT-core time utilities, replaces the HAL tick
+ * based implementation when building with PVC_HOST_BUILD. Time comes from
+ * SimClock, so simulations can switch to virtual time.
+ */
+
+#include <EVT/utils/time.hpp>
+#include <PreCharge/sim/SimClock.hpp>
+
+namespace EVT::core::time {
+
+void wait(uint32_t ms) {
+    PreCharge::sim::SimClock::wait(ms);
+}
+
+uint32_t millis() {
+    return PreCharge::sim::SimClock::now();
+}
+
+}// namespace EVT::core::time
@@ -0,0 +1,80 @@
+/**
+ * Checks the contactor driver against an e-stop interrupt landing in the
+ * middle of a close request: after requestOpen(false) has checked for an
+ * emergency, but before its write to cont2 reaches the pin. cont2 must be
+ * released before requestOpen() returns, rather than stay energized next to
+ * the emergency open pulse until the next process(), and the emergency open
+ * pulse must then run its course.
+ *
+ * Usage: ContactorRaceSim
+ * Exits with 1 if any check fails.
+ */
+
+#include <EVT/utils/time.hpp>
+#include <PreCharge/dev/Contactor.hpp>
+#include <PreCharge/sim/SimClock.hpp>
+#include <PreCharge/sim/SimGPIO.hpp>
+
+#include <cstdio>
+
+namespace IO = EVT::core::IO;
+namespace sim = PreCharge::sim;
+
+/**
+ * Simulated pin that takes the e-stop interrupt just before its next HIGH
+ * write lands, once armed
+ */
+class InterruptedGPIO : public sim::SimGPIO {
+public:
+    using sim::SimGPIO::SimGPIO;
+
+    /** Contactor to open from the interrupt */
+    PreCharge::Contactor* contactor = nullptr;
+    /** Whether the next HIGH write is interrupted */
+    bool armed = false;
+
+    void writePin(State state) override {
+        if (armed && state == State::HIGH) {
+            armed = false;
+            contactor->emergencyOpen();
+        }
+        sim::SimGPIO::writePin(state);
+    }
+};
+
+int main() {
+    sim::SimClock::setMode(sim::SimClock::Mode::VIRTUAL);
+
+    sim::SimGPIO cont1(IO::Pin::PA_0);
+    InterruptedGPIO cont2(IO::Pin::PA_1);
+    PreCharge::Contactor contactor(cont1, cont2);
+    cont2.contactor = &contactor;
+
+    cont2.armed = true;
+    contactor.requestOpen(false);
+
+    bool released = cont2.readPin() == IO::GPIO::State::LOW;
+    bool opening = cont1.readPin() == IO::GPIO::State::HIGH;
+    printf("after request:    cont1 %s, cont2 %s\n", opening ? "HIGH" : "LOW", released ? "LOW" : "HIGH");
+
+    // Close requests are ignored until process() takes over the pulse
+    contactor.requestOpen(false);
+    bool ignored = cont2.readPin() == IO::GPIO::State::LOW;
+
+    uint32_t start = EVT::core::time::millis();
+    while (contactor.getActuation() != PreCharge::Contactor::Actuation::IDLE
+           && EVT::core::time::millis() - start < 10 * PreCharge::Contactor::PULSE_DURATION) {
+        contactor.process();
+        bool both = cont1.readPin() == IO::GPIO::State::HIGH && cont2.readPin() == IO::GPIO::State::HIGH;
+        released = released && !both;
+        EVT::core::time::wait(1);
+    }
+    bool open = contactor.getActuation() == PreCharge::Contactor::Actuation::IDLE && contactor.openState()
+                && cont1.readPin() == IO::GPIO::State::LOW && cont2.readPin() == IO::GPIO::State::LOW;
+    printf("after pulse:      %s, coils %s\n", contactor.openState() ? "open" : "closed",
+           open ? "released" : "still driven");
+
+    bool ok = released && opening && ignored && open;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
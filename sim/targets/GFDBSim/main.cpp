@@ -0,0 +1,57 @@
+/**
+ * Checks the GFDB driver's response handling against the SIM100 model: a
+ * blocking request for a full response, and a reply too short to hold one,
+ * on both the blocking and the asynchronous path.
+ *
+ * Usage: GFDBSim
+ * Exits with 1 if any check fails.
+ */
+
+#include <PreCharge/GFDB.hpp>
+#include <PreCharge/sim/SimCAN.hpp>
+#include <PreCharge/sim/SimClock.hpp>
+#include <PreCharge/sim/SimSIM100.hpp>
+
+#include <cstdio>
+
+namespace IO = EVT::core::IO;
+namespace sim = PreCharge::sim;
+
+int main() {
+    sim::SimClock::setMode(sim::SimClock::Mode::VIRTUAL);
+
+    sim::SimCAN can;
+    sim::SimSIM100 sim100;
+    sim100.attach(can);
+    can.connect();
+    GFDB::GFDB gfdb(can);
+
+    // Full response, 8 byte frame, read with the blocking helper
+    sim100.setIsolationState(0b11);
+    uint8_t isoState = 0;
+    bool full = gfdb.requestIsolationState(&isoState) == IO::CAN::CANStatus::OK && isoState == 0b11;
+    printf("8 byte reply:     %s, isolation state %u\n", full ? "read" : "not read", isoState);
+
+    // Reply with only the command and two bytes, the SIM100 silent otherwise
+    sim100.setResponding(false);
+    uint8_t payload[8] = {GFDB::ISO_STATE_REQ_CMD, 0b11, 0};
+    IO::CANMessage shortReply(sim::SimSIM100::REPLY_ID, 3, payload, true);
+    can.inject(shortReply);
+    isoState = 0;
+    bool blockingRejected = gfdb.requestIsolationState(&isoState) != IO::CAN::CANStatus::OK;
+    printf("3 byte reply:     %s by the blocking request\n", blockingRejected ? "rejected" : "accepted");
+
+    // The same on the asynchronous path, with an empty frame as well
+    gfdb.queueRequest(GFDB::ISO_STATE_REQ_CMD);
+    gfdb.process();
+    IO::CANMessage emptyReply(sim::SimSIM100::REPLY_ID, 0, payload, true);
+    IO::CANMessage fullReply(sim::SimSIM100::REPLY_ID, 8, payload, true);
+    bool asyncRejected = !gfdb.handleCANMessage(emptyReply) && !gfdb.handleCANMessage(shortReply);
+    bool asyncMatched = gfdb.handleCANMessage(fullReply);
+    printf("0 and 3 byte:     %s by the queued request, 8 byte %s\n", asyncRejected ? "rejected" : "accepted",
+           asyncMatched ? "matched" : "not matched");
+
+    bool ok = full && blockingRejected && asyncRejected && asyncMatched;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/**
+ * Decodes the binary log written by PreCharge::log::BinaryLog back into
+ * text. Reads the raw UART stream from a file, or from stdin so it can sit
+ * on the end of a serial port, and prints one line per message.
+ *
+ * Bytes that are not part of a valid frame, such as the text the EVT logger
+ * prints during start up, are passed through unchanged.
+ *
+ * Usage: LogDecoder [file]
+ */
+
+#include <PreCharge/BinaryLog.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+using PreCharge::log::BinaryLog;
+
+int main(int argc, char** argv) {
+    FILE* in = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    if (in == nullptr) {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    uint8_t data[4096];
+    size_t size = 0;
+    uint32_t messages = 0;
+    uint32_t skipped = 0;
+    bool eof = false;
+
+    while (!eof || size > 0) {
+        if (!eof) {
+            size_t count = fread(data + size, 1, sizeof(data) - size, in);
+            eof = count == 0;
+            size += count;
+        }
+
+        size_t pos = 0;
+        while (pos < size) {
+            BinaryLog::Record record;
+            int32_t length = BinaryLog::parse(data + pos, size - pos, record);
+            if (length > 0) {
+                char line[BinaryLog::MAX_LINE_SIZE];
+                BinaryLog::format(record, line, sizeof(line));
+                fputs(line, stdout);
+                pos += length;
+                messages++;
+            } else if (length == 0 && !eof) {
+                // Partial frame, wait for the rest of it
+                break;
+            } else {
+                if (data[pos] == BinaryLog::SYNC) {
+                    skipped++;
+                } else {
+                    fputc(data[pos], stdout);
+                }
+                pos++;
+            }
+        }
+
+        memmove(data, data + pos, size - pos);
+        size -= pos;
+    }
+
+    fprintf(stderr, "%u messages decoded, %u corrupt frames skipped\n", messages, skipped);
+    return 0;
+}
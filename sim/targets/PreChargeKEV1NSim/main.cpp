@@ -0,0 +1,217 @@
+/**
+ * Checks the bus traffic of a KEV1N precharge. Keys on and runs the
+ * targets/PreChargeKEV1N main loop until the state at 0x2100 reaches MC_ON,
+ * then checks that the timed precharge sent exactly one change PDO on entry
+ * and one on exit, that handle() kept returning to the main loop while it
+ * ran and that it took PRECHARGE_DELAY. The exit PDO has to be in KEV1N's
+ * layout: byte 0 is the state left, PRECHARGE, and there is no volt field.
+ * The precharge handler and getSTO() have to show up in the execution time
+ * profile at 0x2104 and 0x2109, and a frame on RPDO0's COB-ID has to be
+ * rejected as KEV1N has no RPDO.
+ *
+ * Runs on real time, so a precharge that blocks inside handle() is measured
+ * rather than skipped over by the virtual clock.
+ *
+ * Usage: PreChargeKEV1NSim
+ * Exits with 1 if any check fails.
+ */
+
+#include <EVT/utils/log.hpp>
+#include <EVT/utils/time.hpp>
+#include <PreCharge/GFDB.hpp>
+#include <PreCharge/PreChargeKEV1N.hpp>
+#include <PreCharge/sim/SimCAN.hpp>
+#include <PreCharge/sim/SimGPIO.hpp>
+#include <PreCharge/sim/SimHVBus.hpp>
+#include <PreCharge/sim/SimSIM100.hpp>
+#include <PreCharge/sim/SimSPI.hpp>
+#include <PreCharge/sim/SimUART.hpp>
+
+#include <cstdio>
+
+namespace IO = EVT::core::IO;
+namespace sim = PreCharge::sim;
+
+using PreCharge::PreChargeKEV1N;
+
+/** Raw ADC count of the simulated pack, roughly 90 V through the divider */
+constexpr uint16_t PACK_COUNTS = 3357;
+
+/** Period of the main loop, in milliseconds, shorter than the target's 100 ms to catch stray frames */
+constexpr uint32_t LOOP_PERIOD = 10;
+
+/** Give up if MC_ON is not reached within this many loops */
+constexpr uint32_t MAX_LOOPS = 1000;
+
+/** Change PDOs a precharge may send, one on entering PRECHARGE and one on leaving it */
+constexpr uint32_t EXPECTED_FRAMES = 2;
+
+/** Longest a pass of handle() may take before it counts as blocking, in milliseconds */
+constexpr uint32_t MAX_PASS_TIME = LOOP_PERIOD;
+
+struct CANInterruptParams {
+    PreCharge::CANDispatcher* dispatcher;
+};
+
+void canInterruptHandler(IO::CANMessage& message, void* priv) {
+    auto* canStruct = static_cast<CANInterruptParams*>(priv);
+    if (canStruct->dispatcher != nullptr) {
+        canStruct->dispatcher->dispatch(message);
+    }
+}
+
+/**
+ * Finds an entry of the object dictionary, as an SDO upload would.
+ *
+ * @param[in] index Index of the entry
+ * @param[in] sub Sub-index of the entry
+ * @return The entry, or nullptr if the dictionary does not have it
+ */
+CO_OBJ_T* findEntry(PreChargeKEV1N& precharge, uint16_t index, uint8_t sub) {
+    CO_OBJ_T* dict = precharge.getObjectDictionary();
+    for (uint8_t i = 0; i < precharge.getNumElements(); i++) {
+        if ((dict[i].Key >> 8) == ((static_cast<uint32_t>(index) << 8) | sub)) {
+            return &dict[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Reads the state out of the object dictionary at 0x2100 sub-index 1.
+ * KEV1N's change PDO reports the state a transition left, not the one it
+ * went to.
+ *
+ * @return The current state
+ */
+PreChargeKEV1N::State currentState(PreChargeKEV1N& precharge) {
+    CO_OBJ_T* entry = findEntry(precharge, 0x2100, 1);
+    if (entry == nullptr) {
+        return PreChargeKEV1N::State::MC_OFF;
+    }
+    return static_cast<PreChargeKEV1N::State>(*reinterpret_cast<uint8_t*>(entry->Data));
+}
+
+/**
+ * Reads the call count of an execution time profile entry
+ *
+ * @return The call count, 0 if the dictionary does not have the entry
+ */
+uint32_t profileCalls(PreChargeKEV1N& precharge, uint16_t index) {
+    CO_OBJ_T* entry = findEntry(precharge, index, 1);
+    return entry == nullptr ? 0 : *reinterpret_cast<uint32_t*>(entry->Data);
+}
+
+int main() {
+    sim::SimUART uart(stderr);
+    EVT::core::log::LOGGER.setUART(&uart);
+    EVT::core::log::LOGGER.setLogLevel(EVT::core::log::Logger::LogLevel::ERROR);
+
+    sim::SimGPIO key(PreChargeKEV1N::KEY_IN_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO batteryOne(PreChargeKEV1N::BAT_OK_1_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO batteryTwo(PreChargeKEV1N::BAT_OK_2_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO eStop(PreChargeKEV1N::ESTOP_IN_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO pc(PreChargeKEV1N::PC_CTL_PIN);
+    sim::SimGPIO dc(PreChargeKEV1N::DC_CTL_PIN);
+    sim::SimGPIO apm(PreChargeKEV1N::APM_CTL_PIN);
+    sim::SimGPIO cont1(PreChargeKEV1N::CONT1_PIN);
+    sim::SimGPIO cont2(PreChargeKEV1N::CONT2_PIN);
+
+    sim::SimSPI spi;
+    sim::SimHVBus bus(pc, dc, PACK_COUNTS, PreChargeKEV1N::CONST_R * PreChargeKEV1N::CONST_C);
+    bus.attach(spi);
+
+    sim::SimCAN can;
+    sim::SimSIM100 sim100;
+    CANInterruptParams canParams = {nullptr};
+    can.addIRQHandler(canInterruptHandler, &canParams);
+    sim100.attach(can);
+    can.connect();
+
+    PreCharge::MAX22530 MAX(spi);
+    PreCharge::Contactor cont(cont1, cont2);
+    GFDB::GFDB gfdb(can);
+    PreChargeKEV1N precharge(key, batteryOne, batteryTwo, eStop, pc, dc, cont, apm, gfdb, can, MAX);
+    canParams.dispatcher = &precharge.getCANDispatcher();
+
+    batteryOne.setInput(IO::GPIO::State::HIGH);
+    batteryTwo.setInput(IO::GPIO::State::HIGH);
+    eStop.setInput(IO::GPIO::State::HIGH);
+    key.setInput(IO::GPIO::State::HIGH);
+
+    bool prechargeSeen = false;
+    bool mcOn = false;
+    uint32_t entryFrames = 0;
+    uint32_t prechargeStart = 0;
+    uint32_t prechargeTime = 0;
+    uint32_t passes = 0;
+    uint32_t preOpPasses = 0;
+    uint32_t opPasses = 0;
+    uint32_t longestPass = 0;
+
+    for (uint32_t i = 0; i < MAX_LOOPS && !mcOn; i++) {
+        uint32_t frames = can.getTransmitCount(0x48A);
+        uint32_t passStart = EVT::core::time::millis();
+        PreChargeKEV1N::PVCStatus status = precharge.handle(uart);
+        uint32_t passTime = EVT::core::time::millis() - passStart;
+
+        PreChargeKEV1N::State state = currentState(precharge);
+        if (!prechargeSeen && state == PreChargeKEV1N::State::PRECHARGE) {
+            prechargeSeen = true;
+            entryFrames = frames;
+            prechargeStart = passStart;
+        }
+        if (prechargeSeen) {
+            passes++;
+            preOpPasses += status == PreChargeKEV1N::PVCStatus::PVC_PRE_OP ? 1 : 0;
+            opPasses += status == PreChargeKEV1N::PVCStatus::PVC_OP ? 1 : 0;
+            if (passTime > longestPass) {
+                longestPass = passTime;
+            }
+        }
+        if (state == PreChargeKEV1N::State::MC_ON) {
+            mcOn = true;
+            prechargeTime = EVT::core::time::millis() - prechargeStart;
+        } else {
+            EVT::core::time::wait(LOOP_PERIOD);
+        }
+    }
+
+    uint32_t prechargeFrames = can.getTransmitCount(0x48A) - entryFrames;
+    IO::CANMessage pdo;
+    can.getLastFrame(0x48A, &pdo);
+    bool layout = pdo.getPayload()[0] == static_cast<uint8_t>(PreChargeKEV1N::State::PRECHARGE)
+                  && (pdo.getPayload()[6] & 0x0F) == 0;
+
+    printf("precharge:        %s in %u ms over %u passes (%u pre-op, %u op)\n",
+           mcOn ? "reached MC_ON" : "did not reach MC_ON", prechargeTime, passes, preOpPasses, opPasses);
+    printf("change PDOs:      %u sent, %u expected\n", prechargeFrames, EXPECTED_FRAMES);
+    printf("longest pass:     %u ms, %u allowed\n", longestPass, MAX_PASS_TIME);
+    printf("exit PDO:         state %u, byte 6 0x%02X, %s\n", pdo.getPayload()[0], pdo.getPayload()[6],
+           layout ? "KEV1N layout" : "not KEV1N layout");
+
+    // The precharge handler and getSTO() profiled through the shared core
+    uint32_t prechargeCalls = profileCalls(precharge, 0x2104);
+    uint32_t stoCalls = profileCalls(precharge, 0x2109);
+    printf("profile:          %u precharge handler, %u getSTO() calls\n", prechargeCalls, stoCalls);
+
+    // KEV1N has no RPDO0, so its COB-ID has to be rejected, not queued for CANopen
+    uint8_t rpdoPayload[2] = {0};
+    IO::CANMessage rpdo(0x200 + PreChargeKEV1N::NODE_ID, 2, rpdoPayload, false);
+    uint32_t rejected = precharge.getCANDispatcher().getStats().rejected;
+    can.inject(rpdo);
+    bool rpdoRejected = precharge.getCANDispatcher().getStats().rejected == rejected + 1;
+    printf("RPDO0 COB-ID:     %s\n", rpdoRejected ? "rejected" : "accepted");
+
+    bool ok = mcOn
+              && prechargeFrames == EXPECTED_FRAMES
+              && longestPass <= MAX_PASS_TIME
+              && prechargeTime >= PreChargeKEV1N::PRECHARGE_DELAY
+              && opPasses == 1
+              && layout
+              && prechargeCalls > 0
+              && stoCalls > 0
+              && rpdoRejected;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
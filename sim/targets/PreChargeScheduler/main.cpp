@@ -0,0 +1,368 @@
+/**
+ * Compares the e-stop response of the PreCharge state machine when driven by
+ * the old fixed 100 ms loop, by the PreCharge::Scheduler task set used by
+ * targets/PreCharge, and by the scheduler with the e-stop interrupt enabled.
+ * Runs on virtual time: key on, wait for MC_ON, press the e-stop at a varying
+ * point in the loop period and measure how long it takes for the change PDO
+ * to report that MC_ON was left and for the outputs to be safe (precharge
+ * and APM off, contactor open pulse started).
+ *
+ * It also checks the scheduler's deadline accounting with a 1 ms task that
+ * ends on the next tick every other run, and overruns once. Only the
+ * releases lost to the overrun may count as missed.
+ *
+ * The scheduled runs also check that the GFDB task keeps the cached
+ * isolation state refreshed at the poller's ISOLATION_STATE_PERIOD.
+ *
+ * Exits with 1 if the accounting or isolation state check fails.
+ */
+
+#include <EVT/utils/log.hpp>
+#include <EVT/utils/time.hpp>
+#include <PreCharge/GFDB.hpp>
+#include <PreCharge/PreCharge.hpp>
+#include <PreCharge/Scheduler.hpp>
+#include <PreCharge/sim/SimCAN.hpp>
+#include <PreCharge/sim/SimClock.hpp>
+#include <PreCharge/sim/SimGPIO.hpp>
+#include <PreCharge/sim/SimHVBus.hpp>
+#include <PreCharge/sim/SimSIM100.hpp>
+#include <PreCharge/sim/SimSPI.hpp>
+#include <PreCharge/sim/SimUART.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace IO = EVT::core::IO;
+namespace sim = PreCharge::sim;
+
+/** Raw ADC count of the simulated pack, roughly 90 V through the divider */
+constexpr uint16_t PACK_COUNTS = 3357;
+
+/** Period of the old main loop, in milliseconds */
+constexpr uint32_t LOOP_PERIOD = 100;
+
+/** Give up on a phase after this much simulated time, in milliseconds */
+constexpr uint32_t PHASE_TIMEOUT = 60000;
+
+/**
+ * Oldest the cached isolation state may get under the scheduler, in
+ * milliseconds: one poll period, plus one more for the response
+ */
+constexpr uint32_t MAX_ISOLATION_AGE = 2 * GFDB::GFDBPoller::ISOLATION_STATE_PERIOD;
+
+struct CANInterruptParams {
+    PreCharge::CANDispatcher* dispatcher;
+};
+
+void canInterruptHandler(IO::CANMessage& message, void* priv) {
+    auto* canStruct = static_cast<CANInterruptParams*>(priv);
+    if (canStruct->dispatcher != nullptr) {
+        canStruct->dispatcher->dispatch(message);
+    }
+}
+
+void safetyTask(void* priv) {
+    static_cast<PreCharge::PreCharge*>(priv)->handleSafety();
+}
+
+void adcTask(void* priv) {
+    static_cast<PreCharge::PreCharge*>(priv)->handleADC();
+}
+
+void gfdbTask(void* priv) {
+    static_cast<PreCharge::PreCharge*>(priv)->handleGFDB();
+}
+
+void commsTask(void* priv) {
+    static_cast<GFDB::GFDB*>(priv)->process();
+}
+
+/** Number of runs of the accounting task, and the run that overruns */
+struct AccountingLoad {
+    uint32_t runs;
+    uint32_t overrunAt;
+};
+
+/**
+ * Ends on the next tick every other run, as a short task started late in a
+ * millisecond would, and takes 3 ms once
+ */
+void accountingTask(void* priv) {
+    auto* load = static_cast<AccountingLoad*>(priv);
+    load->runs++;
+    if (load->runs == load->overrunAt) {
+        sim::SimClock::advance(3);
+    } else if (load->runs % 2) {
+        sim::SimClock::advance(1);
+    }
+}
+
+/**
+ * Runs the accounting task for a second and checks its misses
+ *
+ * @return false if a release was counted as missed without being overrun,
+ * or the overrun was not counted
+ */
+bool checkAccounting() {
+    constexpr uint32_t DURATION = 1000;
+    /** Releases that pass while the overrunning run is still going */
+    constexpr uint32_t OVERRUN_MISSES = 2;
+
+    AccountingLoad load = {0, DURATION / 2};
+    PreCharge::Scheduler scheduler;
+    uint8_t id = scheduler.addTask(accountingTask, &load, 1);
+
+    uint32_t start = EVT::core::time::millis();
+    while (EVT::core::time::millis() - start < DURATION) {
+        scheduler.runOnce();
+        sim::SimClock::advance(1);
+    }
+
+    const PreCharge::Scheduler::TaskStats& stats = scheduler.getStats(id);
+    bool ok = stats.misses == OVERRUN_MISSES && stats.runs + stats.misses >= DURATION - 1;
+    printf("accounting    : %u runs, %u misses over %u ms, %u expected from the overrun, %s\n", stats.runs,
+           stats.misses, DURATION, OVERRUN_MISSES, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+/**
+ * What drives the state machine during a run
+ */
+enum class Drive {
+    // Old fixed 100 ms loop calling handle()
+    LOOP,
+    // Scheduler task set, e-stop polled by the safety task
+    SCHEDULER,
+    // Scheduler task set with the e-stop interrupt enabled
+    SCHEDULER_IRQ
+};
+
+/**
+ * The simulated board and the PreCharge instance under test
+ */
+struct Bench {
+    sim::SimGPIO key{PreCharge::PreCharge::KEY_IN_PIN, IO::GPIO::Direction::INPUT};
+    sim::SimGPIO batteryOne{PreCharge::PreCharge::BAT_OK_1_PIN, IO::GPIO::Direction::INPUT};
+    sim::SimGPIO batteryTwo{PreCharge::PreCharge::BAT_OK_2_PIN, IO::GPIO::Direction::INPUT};
+    sim::SimGPIO eStop{PreCharge::PreCharge::ESTOP_IN_PIN, IO::GPIO::Direction::INPUT};
+    sim::SimGPIO pc{PreCharge::PreCharge::PC_CTL_PIN};
+    sim::SimGPIO dc{PreCharge::PreCharge::DC_CTL_PIN};
+    sim::SimGPIO apm{PreCharge::PreCharge::APM_CTL_PIN};
+    sim::SimGPIO cont1{PreCharge::PreCharge::CONT1_PIN};
+    sim::SimGPIO cont2{PreCharge::PreCharge::CONT2_PIN};
+
+    sim::SimSPI spi;
+    sim::SimHVBus bus{pc, dc, PACK_COUNTS, PreCharge::PreCharge::CONST_R * PreCharge::PreCharge::CONST_C};
+    sim::SimCAN can;
+    sim::SimSIM100 sim100;
+    CANInterruptParams canParams{nullptr};
+
+    PreCharge::MAX22530 MAX{spi};
+    PreCharge::Contactor cont{cont1, cont2};
+    GFDB::GFDB gfdb{can};
+    PreCharge::PreCharge precharge{key, batteryOne, batteryTwo, eStop, pc, dc, cont, apm, gfdb, can, MAX};
+
+    PreCharge::Scheduler scheduler;
+    bool scheduled;
+
+    explicit Bench(Drive drive) : scheduled(drive != Drive::LOOP) {
+        bus.attach(spi);
+        can.addIRQHandler(canInterruptHandler, &canParams);
+        sim100.attach(can);
+        can.connect();
+        canParams.dispatcher = &precharge.getCANDispatcher();
+
+        scheduler.addTask(safetyTask, &precharge, 1);
+        scheduler.addTask(adcTask, &precharge, 10);
+        scheduler.addTask(gfdbTask, &precharge, GFDB::GFDBPoller::ISOLATION_STATE_PERIOD);
+        scheduler.addTask(commsTask, &gfdb, 0);
+
+        batteryOne.setInput(IO::GPIO::State::HIGH);
+        batteryTwo.setInput(IO::GPIO::State::HIGH);
+        eStop.setInput(IO::GPIO::State::HIGH);
+
+        if (drive == Drive::SCHEDULER_IRQ) {
+            precharge.enableEStopInterrupt();
+        }
+    }
+
+    /** Time of the next pass of the main loop, in milliseconds */
+    uint32_t nextPass = EVT::core::time::millis();
+
+    /** Oldest the cached isolation state has been after a pass, in milliseconds */
+    uint32_t maxIsolationAge = 0;
+
+    /**
+     * Waits for the next pass of the main loop and runs it
+     */
+    void step() {
+        uint32_t now = EVT::core::time::millis();
+        if (static_cast<int32_t>(nextPass - now) > 0) {
+            sim::SimClock::advance(nextPass - now);
+        }
+
+        if (scheduled) {
+            scheduler.runOnce();
+            nextPass += 1;
+        } else {
+            precharge.handle();
+            nextPass += LOOP_PERIOD;
+        }
+
+        const GFDB::GFDBPoller::Snapshot& snapshot = precharge.getGFDBSnapshot();
+        if (snapshot.validMask & (1u << GFDB::GFDBPoller::ISOLATION_STATE)) {
+            uint32_t age = EVT::core::time::millis() - snapshot.timestamp[GFDB::GFDBPoller::ISOLATION_STATE];
+            if (age > maxIsolationAge) {
+                maxIsolationAge = age;
+            }
+        }
+    }
+
+    /**
+     * Keeps the main loop running for a while
+     *
+     * @param[in] ms Time to run for, in milliseconds
+     */
+    void runFor(uint32_t ms) {
+        uint32_t end = EVT::core::time::millis() + ms;
+        while (static_cast<int32_t>(nextPass - end) <= 0) {
+            step();
+        }
+        sim::SimClock::advance(end - EVT::core::time::millis());
+    }
+
+    /**
+     * @return The state reported by the last change PDO
+     */
+    PreCharge::PreCharge::State reportedState() {
+        IO::CANMessage pdo;
+        can.getLastFrame(0x48A, &pdo);
+        return static_cast<PreCharge::PreCharge::State>(pdo.getPayload()[0]);
+    }
+
+    /**
+     * @return true once precharge and the APM are off and the contactor is
+     * open or being opened
+     */
+    bool outputsSafe() {
+        return pc.readPin() == IO::GPIO::State::LOW && apm.readPin() == IO::GPIO::State::LOW
+               && (cont1.readPin() == IO::GPIO::State::HIGH || cont.openState());
+    }
+
+    /**
+     * Runs the main loop until the change PDO does or does not report a state
+     *
+     * @return false if that did not happen within PHASE_TIMEOUT
+     */
+    bool runUntil(PreCharge::PreCharge::State target, bool reached = true) {
+        uint32_t start = EVT::core::time::millis();
+        while (EVT::core::time::millis() - start < PHASE_TIMEOUT) {
+            step();
+            if ((reportedState() == target) == reached) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * Runs e-stop trials and prints the response times
+ *
+ * @return false if a scheduled run let the cached isolation state get older
+ * than MAX_ISOLATION_AGE
+ */
+bool runTrials(Drive drive, uint32_t trials) {
+    Bench bench(drive);
+
+    uint32_t total = 0;
+    uint32_t worst = 0;
+    uint32_t safeTotal = 0;
+    uint32_t safeWorst = 0;
+    uint32_t failures = 0;
+    for (uint32_t i = 0; i < trials; i++) {
+        bench.key.setInput(IO::GPIO::State::HIGH);
+        if (!bench.runUntil(PreCharge::PreCharge::State::MC_ON)) {
+            failures++;
+            continue;
+        }
+
+        // Press the e-stop at a different point in the loop period each time
+        bench.runFor(i * 7 % LOOP_PERIOD);
+        bench.eStop.setInput(IO::GPIO::State::LOW);
+        uint32_t pressed = EVT::core::time::millis();
+
+        // Run until both the PDO has reported leaving MC_ON and the outputs are safe
+        int32_t response = -1;
+        int32_t safe = -1;
+        while (EVT::core::time::millis() - pressed < PHASE_TIMEOUT) {
+            if (safe < 0 && bench.outputsSafe()) {
+                safe = EVT::core::time::millis() - pressed;
+            }
+            if (response < 0 && bench.reportedState() != PreCharge::PreCharge::State::MC_ON) {
+                response = EVT::core::time::millis() - pressed;
+            }
+            if (safe >= 0 && response >= 0) {
+                break;
+            }
+            bench.step();
+        }
+
+        if (safe < 0 || response < 0) {
+            failures++;
+        } else {
+            total += response;
+            worst = static_cast<uint32_t>(response) > worst ? response : worst;
+            safeTotal += safe;
+            safeWorst = static_cast<uint32_t>(safe) > safeWorst ? safe : safeWorst;
+        }
+
+        bench.key.setInput(IO::GPIO::State::LOW);
+        bench.eStop.setInput(IO::GPIO::State::HIGH);
+        if (!bench.runUntil(PreCharge::PreCharge::State::MC_OFF)) {
+            failures++;
+        }
+    }
+
+    const char* names[] = {"100 ms loop   ", "scheduler     ", "scheduler+IRQ "};
+    printf("%s: left MC_ON avg %.1f ms, max %u ms; outputs safe avg %.1f ms, max %u ms over %u trials, %u failures\n",
+           names[static_cast<int>(drive)], static_cast<double>(total) / trials, worst,
+           static_cast<double>(safeTotal) / trials, safeWorst, trials, failures);
+
+    bool fresh = !bench.scheduled || bench.maxIsolationAge <= MAX_ISOLATION_AGE;
+    if (bench.scheduled) {
+        const char* taskNames[] = {"safety", "adc", "gfdb", "comms"};
+        for (uint8_t i = 0; i < bench.scheduler.getNumTasks(); i++) {
+            const PreCharge::Scheduler::TaskStats& stats = bench.scheduler.getStats(i);
+            printf("  %-6s runs %u, misses %u, max lateness %u ms\n", taskNames[i], stats.runs, stats.misses, stats.maxLateness);
+        }
+        printf("  isolation state max age %u ms, %u allowed, %s\n", bench.maxIsolationAge, MAX_ISOLATION_AGE,
+               fresh ? "PASS" : "FAIL");
+    }
+
+    if (drive == Drive::SCHEDULER_IRQ) {
+        PreCharge::PreCharge::EStopStats stats = bench.precharge.getEStopStats();
+        printf("  e-stop interrupt: %u taken, handler to outputs safe last %u ns, max %u ns (host)\n",
+               stats.count, stats.lastLatency, stats.maxLatency);
+    }
+
+    return fresh;
+}
+
+int main(int argc, char** argv) {
+    uint32_t trials = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100;
+
+    sim::SimClock::setMode(sim::SimClock::Mode::VIRTUAL);
+
+    sim::SimUART uart(stderr);
+    EVT::core::log::LOGGER.setUART(&uart);
+    EVT::core::log::LOGGER.setLogLevel(EVT::core::log::Logger::LogLevel::ERROR);
+
+    bool ok = runTrials(Drive::LOOP, trials);
+    ok = runTrials(Drive::SCHEDULER, trials) && ok;
+    ok = runTrials(Drive::SCHEDULER_IRQ, trials) && ok;
+    ok = checkAccounting() && ok;
+
+    return ok ? 0 : 1;
+}
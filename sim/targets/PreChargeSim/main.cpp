@@ -0,0 +1,189 @@
+/**
+ * Host simulation of the PreCharge state machine. Drives the simulated IO
+ * through a key-on precharge and reports the throughput and per-call latency
+ * of PreCharge::handle().
+ *
+ * Usage: PreChargeSim [iterations] [log file]
+ * With a log file the binary log is drained into it between calls, for
+ * reading back with LogDecoder.
+ */
+
+#include <EVT/utils/log.hpp>
+#include <PreCharge/BinaryLog.hpp>
+#include <PreCharge/GFDB.hpp>
+#include <PreCharge/PreCharge.hpp>
+#include <PreCharge/sim/SimCAN.hpp>
+#include <PreCharge/sim/SimGPIO.hpp>
+#include <PreCharge/sim/SimHVBus.hpp>
+#include <PreCharge/sim/SimSIM100.hpp>
+#include <PreCharge/sim/SimSPI.hpp>
+#include <PreCharge/sim/SimUART.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace IO = EVT::core::IO;
+namespace sim = PreCharge::sim;
+
+/** Raw ADC count of the simulated pack, roughly 90 V through the divider */
+constexpr uint16_t PACK_COUNTS = 3357;
+
+/** Sections profiled at 0x2101 onward in the object dictionary, in order */
+const char* const PROFILE_NAMES[] = {
+    "MC_OFF", "MC_ON", "ESTOPWAIT", "PRECHARGE", "DISCHARGE", "CONT_OPEN", "CONT_CLOSE", "FORWARD_DISABLE",
+    "getSTO", "GFDB::process", "readChannels"};
+
+/**
+ * Reads a 32 bit entry out of an object dictionary the way an SDO upload
+ * would, by looking up its index and sub-index.
+ */
+uint32_t readOD(CANDevice& device, uint16_t index, uint8_t subIndex) {
+    CO_OBJ_T* dict = device.getObjectDictionary();
+    for (uint8_t i = 0; i < device.getNumElements(); i++) {
+        if ((dict[i].Key >> 8) == ((static_cast<uint32_t>(index) << 8) | subIndex)) {
+            return *reinterpret_cast<const uint32_t*>(dict[i].Data);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Prints the precharge attempts recorded at 0x210C, reading each domain the
+ * way an SDO upload would
+ */
+void printTrace(CANDevice& device) {
+    CO_OBJ_T* dict = device.getObjectDictionary();
+    for (uint8_t i = 0; i < device.getNumElements(); i++) {
+        if ((dict[i].Key >> 16) != 0x210C || ((dict[i].Key >> 8) & 0xFF) == 0) {
+            continue;
+        }
+        auto* domain = reinterpret_cast<CO_OBJ_DOM*>(dict[i].Data);
+        PreCharge::PrechargeTrace::Attempt attempt;
+        memcpy(&attempt, domain->Start, sizeof(attempt));
+        if (attempt.result == static_cast<uint8_t>(PreCharge::PrechargeTrace::Result::EMPTY)) {
+            continue;
+        }
+
+        const PreCharge::PrechargeTrace::Sample& last = attempt.samples[attempt.count - 1];
+        printf("  0x210C sub %u: attempt %u, result %u, %u samples every %u, ends at %u ms (%u ms saved) with %d / %d / %d mV\n",
+               (dict[i].Key >> 8) & 0xFF, attempt.sequence, attempt.result, attempt.count, attempt.stride, last.time, attempt.timeSaved,
+               last.measured * PreCharge::PrechargeTrace::MV_PER_COUNT, last.expected * PreCharge::PrechargeTrace::MV_PER_COUNT,
+               last.pack * PreCharge::PrechargeTrace::MV_PER_COUNT);
+    }
+}
+
+struct CANInterruptParams {
+    PreCharge::CANDispatcher* dispatcher;
+};
+
+void canInterruptHandler(IO::CANMessage& message, void* priv) {
+    auto* canStruct = static_cast<CANInterruptParams*>(priv);
+    if (canStruct->dispatcher != nullptr) {
+        canStruct->dispatcher->dispatch(message);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+    sim::SimUART uart(stderr);
+    EVT::core::log::LOGGER.setUART(&uart);
+    EVT::core::log::LOGGER.setLogLevel(EVT::core::log::Logger::LogLevel::ERROR);
+
+    FILE* logFile = argc > 2 ? fopen(argv[2], "wb") : nullptr;
+    if (argc > 2 && logFile == nullptr) {
+        fprintf(stderr, "Cannot open %s\n", argv[2]);
+        return 1;
+    }
+    sim::SimUART logUART(logFile);
+
+    sim::SimGPIO key(PreCharge::PreCharge::KEY_IN_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO batteryOne(PreCharge::PreCharge::BAT_OK_1_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO batteryTwo(PreCharge::PreCharge::BAT_OK_2_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO eStop(PreCharge::PreCharge::ESTOP_IN_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO pc(PreCharge::PreCharge::PC_CTL_PIN);
+    sim::SimGPIO dc(PreCharge::PreCharge::DC_CTL_PIN);
+    sim::SimGPIO apm(PreCharge::PreCharge::APM_CTL_PIN);
+    sim::SimGPIO cont1(PreCharge::PreCharge::CONT1_PIN);
+    sim::SimGPIO cont2(PreCharge::PreCharge::CONT2_PIN);
+
+    sim::SimSPI spi;
+    sim::SimHVBus bus(pc, dc, PACK_COUNTS, PreCharge::PreCharge::CONST_R * PreCharge::PreCharge::CONST_C);
+    bus.attach(spi);
+
+    sim::SimCAN can;
+    sim::SimSIM100 sim100;
+    CANInterruptParams canParams = {nullptr};
+    can.addIRQHandler(canInterruptHandler, &canParams);
+    sim100.attach(can);
+    can.connect();
+
+    PreCharge::MAX22530 MAX(spi);
+    PreCharge::Contactor cont(cont1, cont2);
+    GFDB::GFDB gfdb(can);
+    PreCharge::PreCharge precharge(key, batteryOne, batteryTwo, eStop, pc, dc, cont, apm, gfdb, can, MAX);
+    canParams.dispatcher = &precharge.getCANDispatcher();
+
+    // Healthy pack, no e-stop, key on
+    batteryOne.setInput(IO::GPIO::State::HIGH);
+    batteryTwo.setInput(IO::GPIO::State::HIGH);
+    eStop.setInput(IO::GPIO::State::HIGH);
+    key.setInput(IO::GPIO::State::HIGH);
+
+    using clock = std::chrono::steady_clock;
+    uint64_t minNs = UINT64_MAX;
+    uint64_t maxNs = 0;
+    uint64_t totalNs = 0;
+
+    auto start = clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        auto before = clock::now();
+        precharge.handle();
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - before).count();
+
+        totalNs += ns;
+        minNs = ns < minNs ? ns : minNs;
+        maxNs = ns > maxNs ? ns : maxNs;
+
+        // Background logging task, outside the measured call
+        if (logFile != nullptr) {
+            PreCharge::log::LOGGER.drain(logUART);
+        }
+    }
+    if (logFile != nullptr) {
+        while (PreCharge::log::LOGGER.drain(logUART) > 0) {}
+        fclose(logFile);
+    }
+    double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    printf("handle() calls:   %u\n", iterations);
+    printf("wall time:        %.3f s\n", seconds);
+    printf("throughput:       %.0f calls/s\n", iterations / seconds);
+    printf("latency min/avg/max: %llu / %llu / %llu ns\n",
+           static_cast<unsigned long long>(minNs),
+           static_cast<unsigned long long>(iterations ? totalNs / iterations : 0),
+           static_cast<unsigned long long>(maxNs));
+    printf("SPI transactions: %u\n", spi.getTransactionCount());
+    printf("CAN frames sent:  %u (change PDO: %u)\n", can.getTransmitCount(), can.getTransmitCount(0x48A));
+    printf("contactor pulses: close %u, open %u\n", cont2.getWriteCount() / 2, cont1.getWriteCount() / 2);
+    printf("contactor actuation time: %u ms\n", cont.getActuationTime());
+    GFDB::GFDB::RequestStats gfdbStats = gfdb.getRequestStats();
+    printf("GFDB requests:    %u sent, %u answered, %u timed out, latency last/max %u / %u ms\n",
+           gfdbStats.requests, gfdbStats.responses, gfdbStats.timeouts, gfdbStats.lastLatency, gfdbStats.maxLatency);
+
+    printf("log messages dropped: %u\n", PreCharge::log::LOGGER.getDropped());
+
+    printf("precharge trace (measured / expected / pack):\n");
+    printTrace(precharge);
+
+    printf("profile from the object dictionary (calls, min/avg/max ns):\n");
+    for (uint8_t i = 0; i < sizeof(PROFILE_NAMES) / sizeof(PROFILE_NAMES[0]); i++) {
+        uint16_t index = 0x2101 + i;
+        printf("  0x%04X %-16s %8u, %u / %u / %u\n", index, PROFILE_NAMES[i],
+               readOD(precharge, index, 1), readOD(precharge, index, 2), readOD(precharge, index, 4), readOD(precharge, index, 3));
+    }
+
+    return 0;
+}
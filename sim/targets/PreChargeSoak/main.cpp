@@ -0,0 +1,270 @@
+/**
+ * Soak test of the PreCharge state machine on virtual time. Runs complete
+ * key-on / key-off cycles (precharge, contactor close, forward disable,
+ * contactor open, discharge) as fast as the host allows and reports how many
+ * cycles per second of wall time were simulated.
+ *
+ * Usage: PreChargeSoak [cycles] [sampled] [tau=<factor>] [inrush=<mV>] [mc=<ms>] [canlimit=<n>] [busload=<n>]
+ * tau= scales the time constant of the simulated bus away from the nominal
+ * one, as a drifted capacitance or resistance would. inrush= sets the
+ * early close limit over the object dictionary, 0 to wait for the done
+ * window. mc= is how long the simulated motor controller takes to report
+ * itself disabled once forward disable starts, -1 for never. canlimit= lets
+ * the simulated bus take only n frames per millisecond, to exercise the
+ * transmit queue. busload= puts n frames on the bus every loop, an eighth of
+ * them SYNCs for the CANopen queue and the rest meant for other nodes, half
+ * of those extended, for the receive filter to reject.
+ *
+ * Without sampled, the ADC is read once per 100 ms loop, too few samples for
+ * the time constant fit, so every fit is rejected. Precharge must then never
+ * close early, and the soak fails if any time was saved.
+ */
+
+#include <EVT/utils/log.hpp>
+#include <EVT/utils/time.hpp>
+#include <PreCharge/GFDB.hpp>
+#include <PreCharge/PreCharge.hpp>
+#include <PreCharge/sim/SimCAN.hpp>
+#include <PreCharge/sim/SimClock.hpp>
+#include <PreCharge/sim/SimGPIO.hpp>
+#include <PreCharge/sim/SimHVBus.hpp>
+#include <PreCharge/sim/SimSIM100.hpp>
+#include <PreCharge/sim/SimSPI.hpp>
+#include <PreCharge/sim/SimTimer.hpp>
+#include <PreCharge/sim/SimUART.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace IO = EVT::core::IO;
+namespace sim = PreCharge::sim;
+
+/** Raw ADC count of the simulated pack, roughly 90 V through the divider */
+constexpr uint16_t PACK_COUNTS = 3357;
+
+/** Period of the main loop in targets/PreCharge, in milliseconds */
+constexpr uint32_t LOOP_PERIOD = 100;
+
+static_assert(PreCharge::PreCharge::PrechargeTauEstimator::FIT_WINDOW_MS / LOOP_PERIOD + 1
+                  < PreCharge::PreCharge::PrechargeTauEstimator::MIN_SAMPLES,
+              "Reading the ADC once per loop has to leave the fit short of samples");
+
+/** Give up on a cycle if a state is not reached within this many loops */
+constexpr uint32_t MAX_LOOPS_PER_PHASE = 1000;
+
+/**
+ * Looks up a 32 bit entry in an object dictionary, as an SDO transfer would
+ *
+ * @return The entry's value, nullptr if it does not exist
+ */
+uint32_t* findOD(CANDevice& device, uint16_t index, uint8_t subIndex) {
+    CO_OBJ_T* dict = device.getObjectDictionary();
+    for (uint8_t i = 0; i < device.getNumElements(); i++) {
+        if ((dict[i].Key >> 8) == ((static_cast<uint32_t>(index) << 8) | subIndex)) {
+            return reinterpret_cast<uint32_t*>(dict[i].Data);
+        }
+    }
+    return nullptr;
+}
+
+struct CANInterruptParams {
+    PreCharge::CANDispatcher* dispatcher;
+};
+
+void canInterruptHandler(IO::CANMessage& message, void* priv) {
+    auto* canStruct = static_cast<CANInterruptParams*>(priv);
+    if (canStruct->dispatcher != nullptr) {
+        canStruct->dispatcher->dispatch(message);
+    }
+}
+
+/**
+ * @return The state reported by the last change PDO
+ */
+PreCharge::PreCharge::State reportedState(sim::SimCAN& can) {
+    IO::CANMessage pdo;
+    can.getLastFrame(0x48A, &pdo);
+    return static_cast<PreCharge::PreCharge::State>(pdo.getPayload()[0]);
+}
+
+/**
+ * Run the main loop until the change PDO reports the target state. While
+ * in FORWARD_DISABLE, the motor controller's status RPDO is delivered
+ * mcDelay milliseconds after the state was entered.
+ *
+ * @return false if the state was not reached or the PVC reported an error
+ */
+bool runUntil(PreCharge::PreCharge& precharge, sim::SimCAN& can, PreCharge::PreCharge::State target, int32_t mcDelay,
+              uint32_t busLoad) {
+    uint32_t forwardDisableStart = 0;
+    bool forwardDisable = false;
+    for (uint32_t i = 0; i < MAX_LOOPS_PER_PHASE; i++) {
+        if (precharge.handle() == PreCharge::PreCharge::PVCStatus::PVC_ERROR) {
+            return false;
+        }
+        PreCharge::PreCharge::State state = reportedState(can);
+        if (state == target) {
+            return true;
+        }
+        if (state != PreCharge::PreCharge::State::FORWARD_DISABLE) {
+            forwardDisable = false;
+        } else if (!forwardDisable) {
+            forwardDisable = true;
+            forwardDisableStart = EVT::core::time::millis();
+        } else if (mcDelay >= 0 && EVT::core::time::millis() - forwardDisableStart >= static_cast<uint32_t>(mcDelay)) {
+            // Zero current, as written by the stack from RPDO0
+            *reinterpret_cast<uint16_t*>(findOD(precharge, 0x2110, 1)) = 0;
+        }
+        for (uint32_t frame = 0; frame < busLoad; frame++) {
+            // SYNCs, other nodes' PDOs and heartbeats, and BMS style extended IDs
+            uint8_t payload[8] = {};
+            uint32_t id = frame % 2 ? 0x18FF0000 + (frame & 0xFF) : 0x180 + (frame % 0x500);
+            IO::CANMessage message(frame % 8 == 0 ? 0x080 : id, 8, payload, frame % 8 != 0 && frame % 2);
+            can.inject(message);
+        }
+        // Once per loop, as CONodeProcess() does on the board
+        CO_IF_FRM frame;
+        while (precharge.getCANopenQueue().pop(&frame)) {
+        }
+        EVT::core::time::wait(LOOP_PERIOD);
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    uint32_t cycles = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000;
+    bool sampled = false;
+    double tauFactor = 1.0;
+    int64_t inrush = -1;
+    int32_t mcDelay = 200;
+    uint8_t canLimit = 0;
+    uint32_t busLoad = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "sampled") == 0) {
+            sampled = true;
+        } else if (strncmp(argv[i], "tau=", 4) == 0) {
+            tauFactor = strtod(argv[i] + 4, nullptr);
+        } else if (strncmp(argv[i], "inrush=", 7) == 0) {
+            inrush = strtol(argv[i] + 7, nullptr, 10);
+        } else if (strncmp(argv[i], "mc=", 3) == 0) {
+            mcDelay = strtol(argv[i] + 3, nullptr, 10);
+        } else if (strncmp(argv[i], "canlimit=", 9) == 0) {
+            canLimit = strtoul(argv[i] + 9, nullptr, 10);
+        } else if (strncmp(argv[i], "busload=", 8) == 0) {
+            busLoad = strtoul(argv[i] + 8, nullptr, 10);
+        }
+    }
+
+    sim::SimClock::setMode(sim::SimClock::Mode::VIRTUAL);
+
+    sim::SimUART uart(stderr);
+    EVT::core::log::LOGGER.setUART(&uart);
+    EVT::core::log::LOGGER.setLogLevel(EVT::core::log::Logger::LogLevel::ERROR);
+
+    sim::SimGPIO key(PreCharge::PreCharge::KEY_IN_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO batteryOne(PreCharge::PreCharge::BAT_OK_1_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO batteryTwo(PreCharge::PreCharge::BAT_OK_2_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO eStop(PreCharge::PreCharge::ESTOP_IN_PIN, IO::GPIO::Direction::INPUT);
+    sim::SimGPIO pc(PreCharge::PreCharge::PC_CTL_PIN);
+    sim::SimGPIO dc(PreCharge::PreCharge::DC_CTL_PIN);
+    sim::SimGPIO apm(PreCharge::PreCharge::APM_CTL_PIN);
+    sim::SimGPIO cont1(PreCharge::PreCharge::CONT1_PIN);
+    sim::SimGPIO cont2(PreCharge::PreCharge::CONT2_PIN);
+
+    sim::SimSPI spi;
+    double tau = PreCharge::PreCharge::CONST_R * PreCharge::PreCharge::CONST_C * tauFactor;
+    sim::SimHVBus bus(pc, dc, PACK_COUNTS, tau);
+    bus.attach(spi);
+
+    sim::SimCAN can;
+    sim::SimSIM100 sim100;
+    CANInterruptParams canParams = {nullptr};
+    can.addIRQHandler(canInterruptHandler, &canParams);
+    sim100.attach(can);
+    can.connect();
+    can.setTransmitLimit(canLimit);
+
+    PreCharge::MAX22530 MAX(spi);
+    PreCharge::Contactor cont(cont1, cont2);
+    GFDB::GFDB gfdb(can);
+    PreCharge::PreCharge precharge(key, batteryOne, batteryTwo, eStop, pc, dc, cont, apm, gfdb, can, MAX);
+    canParams.dispatcher = &precharge.getCANDispatcher();
+
+    if (inrush >= 0) {
+        *findOD(precharge, 0x210E, 1) = static_cast<uint32_t>(inrush);
+    }
+
+    // Optionally sample the ADC from a 1 kHz timer like the target does
+    sim::SimTimer adcTimer(1);
+    if (sampled) {
+        precharge.getSampler().start(adcTimer);
+    }
+
+    batteryOne.setInput(IO::GPIO::State::HIGH);
+    batteryTwo.setInput(IO::GPIO::State::HIGH);
+    eStop.setInput(IO::GPIO::State::HIGH);
+
+    uint32_t startTime = EVT::core::time::millis();
+    uint32_t completed = 0;
+    uint32_t failures = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < cycles; i++) {
+        key.setInput(IO::GPIO::State::HIGH);
+        bool ok = runUntil(precharge, can, PreCharge::PreCharge::State::MC_ON, mcDelay, busLoad);
+
+        key.setInput(IO::GPIO::State::LOW);
+        ok = runUntil(precharge, can, PreCharge::PreCharge::State::MC_OFF, mcDelay, busLoad) && ok;
+
+        if (ok) {
+            completed++;
+        } else {
+            failures++;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double simulated = (EVT::core::time::millis() - startTime) / 1000.0;
+
+    printf("key cycles:       %u completed, %u failed\n", completed, failures);
+    printf("wall time:        %.3f s\n", seconds);
+    printf("simulated time:   %.0f s\n", simulated);
+    printf("throughput:       %.0f cycles/s (%.0fx real time)\n", cycles / seconds, simulated / seconds);
+    printf("CAN frames sent:  %u (change PDO: %u)\n", can.getTransmitCount(), can.getTransmitCount(0x48A));
+    const PreCharge::CANTxQueue::Stats& txStats = precharge.getTxQueue().getStats();
+    const PreCharge::CycleStats& txLatency = precharge.getTxQueue().getLatencyStats();
+    printf("TX queue:         %u sent, %u dropped, %u coalesced, %u most pending, %u refused by the bus\n",
+           txStats.sent, txStats.dropped, txStats.coalesced, txStats.maxDepth, can.getRefusedCount());
+    printf("TX latency:       avg %u ns, max %u ns (host clock)\n", txLatency.avg, txLatency.max);
+    const PreCharge::CANDispatcher::Stats& rxStats = precharge.getCANDispatcher().getStats();
+    const PreCharge::CycleStats& rxTime = precharge.getCANDispatcher().getDispatchStats();
+    printf("RX filter:        %u received, %u standard, %u extended, %u rejected\n",
+           rxStats.received, rxStats.standard, rxStats.extended, rxStats.rejected);
+    printf("RX dispatch:      avg %u ns, max %u ns (host clock)\n", rxTime.avg, rxTime.max);
+    const PreCharge::CANopenQueue::Stats& canopenStats = precharge.getCANopenQueue().getStats();
+    printf("CANopen queue:    %u of %u slots used at most, %u overruns\n",
+           canopenStats.highWater, PreCharge::CANopenQueue::SIZE, canopenStats.overruns);
+    GFDB::GFDB::RequestStats gfdbStats = gfdb.getRequestStats();
+    printf("GFDB requests:    %u sent, %u answered, %u timed out\n",
+           gfdbStats.requests, gfdbStats.responses, gfdbStats.timeouts);
+    printf("precharge tau:    %u ms estimated, %.0f ms simulated\n", precharge.getTauEstimator().getTau(), tau * 1000);
+    const PreCharge::PreCharge::WaitStats& forwardDisable = precharge.getForwardDisableStats();
+    printf("forward disable:  %u done, %u not confirmed, last %u ms, longest %u ms\n",
+           forwardDisable.count, forwardDisable.timeouts, forwardDisable.lastDuration, forwardDisable.maxDuration);
+    const PreCharge::PreCharge::WaitStats& discharge = precharge.getDischargeStats();
+    printf("discharge:        %u done, %u timed out, last %u ms, longest %u ms\n",
+           discharge.count, discharge.timeouts, discharge.lastDuration, discharge.maxDuration);
+    printf("early close:      %u mV limit, %.1f ms saved per precharge\n",
+           *findOD(precharge, 0x210E, 1), completed ? static_cast<double>(*findOD(precharge, 0x210E, 3)) / completed : 0.0);
+    if (sampled) {
+        PreCharge::MAX22530Sampler& sampler = precharge.getSampler();
+        printf("ADC samples:      %u taken, %u overruns\n", sampler.getSampleCount(), sampler.getOverrunCount());
+    } else if (*findOD(precharge, 0x210E, 3) > 0) {
+        // Every fit was rejected, so there was no curve to close early on
+        printf("early close:      FAIL, closed early without a fitted curve\n");
+        failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
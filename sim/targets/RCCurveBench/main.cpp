@@ -0,0 +1,115 @@
+/**
+ * Compares the compile time RC lookup table used by PreCharge::solveForVoltage()
+ * against the exp() based implementation it replaced, both for speed and for
+ * accuracy.
+ */
+
+#include <PreCharge/PreCharge.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+using Curve = PreCharge::PreCharge::PrechargeCurve;
+
+constexpr uint32_t TAU_MS = PreCharge::PreCharge::PRECHARGE_TAU_MS;
+
+/** Evaluate the curve out to this many time constants */
+constexpr uint32_t SPAN_MS = 8 * TAU_MS;
+
+/**
+ * The implementation solveForVoltage() used before the lookup table
+ */
+uint16_t solveWithExp(uint8_t initVolt, uint16_t pack_voltage, uint64_t delta_time) {
+    return initVolt + ((pack_voltage - initVolt) * (1 - exp(-(delta_time / (1000 * 30 * 0.014)))));
+}
+
+uint16_t solveWithTable(uint8_t initVolt, uint16_t pack_voltage, uint64_t delta_time) {
+    return Curve::solve(initVolt, pack_voltage, delta_time);
+}
+
+/**
+ * @return A timestamp in CPU cycles where available, otherwise nanoseconds
+ */
+uint64_t timestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+volatile uint16_t sink;
+
+double benchmark(uint16_t (*solve)(uint8_t, uint16_t, uint64_t), uint32_t rounds) {
+    volatile uint8_t initVolt = 3;
+    volatile uint16_t pack = 90;
+
+    uint64_t start = timestamp();
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (uint32_t t = 0; t < SPAN_MS; t++) {
+            sink = solve(initVolt, pack, t);
+        }
+    }
+    return static_cast<double>(timestamp() - start) / (static_cast<double>(rounds) * SPAN_MS);
+}
+
+int main(int argc, char** argv) {
+    uint32_t rounds = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200;
+
+    // Accuracy of the table itself against the exact curve
+    double maxFractionError = 0;
+    for (uint32_t t = 0; t < SPAN_MS; t++) {
+        double exact = 1 - std::exp(-static_cast<double>(t) / TAU_MS);
+        double table = Curve::lookup(t) / 65536.0;
+        maxFractionError = std::fmax(maxFractionError, std::fabs(exact - table));
+    }
+
+    // Accuracy of invert(), used to estimate tau, against -tau * ln(1 - f)
+    // over the fractions the estimator fits
+    double maxInvertError = 0;
+    for (uint32_t fraction = 65536 / 50; fraction < 65536 * 95 / 100; fraction++) {
+        double exact = -static_cast<double>(TAU_MS) * std::log(1 - fraction / 65536.0);
+        double table = Curve::invert(fraction) / 256.0;
+        maxInvertError = std::fmax(maxInvertError, std::fabs(exact - table));
+    }
+
+    // Accuracy of solveForVoltage() over every pack voltage it can see
+    int maxVoltError = 0;
+    uint32_t mismatches = 0;
+    uint32_t samples = 0;
+    for (uint16_t pack = 0; pack <= UINT8_MAX; pack++) {
+        for (uint32_t t = 0; t < SPAN_MS; t++) {
+            int error = std::abs(solveWithTable(0, pack, t) - solveWithExp(0, pack, t));
+            maxVoltError = error > maxVoltError ? error : maxVoltError;
+            mismatches += error != 0;
+            samples++;
+        }
+    }
+
+    double expCost = benchmark(solveWithExp, rounds);
+    double tableCost = benchmark(solveWithTable, rounds);
+
+#if defined(__x86_64__) || defined(__i386__)
+    const char* unit = "cycles";
+#else
+    const char* unit = "ns";
+#endif
+
+    printf("tau: %u ms, table: %u entries (%zu bytes)\n", TAU_MS, Curve::SIZE, Curve::SIZE * sizeof(uint16_t));
+    printf("max fraction error: %.6f\n", maxFractionError);
+    printf("max invert() error: %.3f ms\n", maxInvertError);
+    printf("max solveForVoltage() error: %d V (%u of %u samples differ)\n", maxVoltError, mismatches, samples);
+    printf("exp():  %.1f %s/call\n", expCost, unit);
+    printf("table:  %.1f %s/call\n", tableCost, unit);
+    printf("speedup: %.1fx\n", expCost / tableCost);
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <PreCharge/BinaryLog.hpp>
+
+#include <EVT/utils/time.hpp>
+
+#include <cstdio>
+
+namespace time = EVT::core::time;
+
+namespace PreCharge::log {
+
+namespace {
+
+/** Format of each message, indexed by MessageID */
+const char* const FORMATS[] = {
+#define PVC_LOG_FORMAT(name, level, format) format,
+    PVC_LOG_MESSAGES(PVC_LOG_FORMAT)
+#undef PVC_LOG_FORMAT
+};
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::DEBUG:
+        return "DEBUG";
+    case LogLevel::INFO:
+        return "INFO";
+    case LogLevel::WARNING:
+        return "WARNING";
+    default:
+        return "ERROR";
+    }
+}
+
+uint32_t readWord(const uint8_t* bytes) {
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+}// namespace
+
+BinaryLog LOGGER;
+
+void BinaryLog::write(MessageID id, const int32_t* args, uint8_t numArgs) {
+    size_t frameSize = HEADER_SIZE + 4 * numArgs + 1;
+    if (BUFFER_SIZE - (head - tail) < frameSize) {
+        dropped++;
+        return;
+    }
+
+    uint8_t frame[MAX_FRAME_SIZE];
+    uint32_t timestamp = time::millis();
+    frame[0] = SYNC;
+    frame[1] = static_cast<uint8_t>(id);
+    frame[2] = numArgs;
+    for (uint8_t i = 0; i < 4; i++) {
+        frame[3 + i] = timestamp >> (8 * i);
+    }
+    for (uint8_t arg = 0; arg < numArgs; arg++) {
+        for (uint8_t i = 0; i < 4; i++) {
+            frame[HEADER_SIZE + 4 * arg + i] = static_cast<uint32_t>(args[arg]) >> (8 * i);
+        }
+    }
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < frameSize - 1; i++) {
+        checksum += frame[i];
+    }
+    frame[frameSize - 1] = checksum;
+
+    for (size_t i = 0; i < frameSize; i++) {
+        buffer[(head + i) & (BUFFER_SIZE - 1)] = frame[i];
+    }
+    head += frameSize;
+}
+
+bool BinaryLog::fillPending() {
+    if (head == tail) {
+        return false;
+    }
+
+    uint8_t frame[MAX_FRAME_SIZE];
+    size_t frameSize = HEADER_SIZE + 4 * buffer[(tail + 2) & (BUFFER_SIZE - 1)] + 1;
+    for (size_t i = 0; i < frameSize; i++) {
+        frame[i] = buffer[(tail + i) & (BUFFER_SIZE - 1)];
+    }
+    tail += frameSize;
+
+    Record record;
+    if (outputFormat == Format::TEXT && parse(frame, frameSize, record) > 0) {
+        pendingSize = format(record, reinterpret_cast<char*>(pending), MAX_LINE_SIZE);
+    } else {
+        for (size_t i = 0; i < frameSize; i++) {
+            pending[i] = frame[i];
+        }
+        pendingSize = frameSize;
+    }
+    pendingPos = 0;
+    return true;
+}
+
+size_t BinaryLog::drain(IO::UART& uart, size_t budget) {
+    size_t written = 0;
+    while (written < budget && uart.isWritable()) {
+        if (pendingPos == pendingSize && !fillPending()) {
+            break;
+        }
+        uart.write(pending[pendingPos++]);
+        written++;
+    }
+    return written;
+}
+
+void BinaryLog::setFormat(Format newFormat) {
+    outputFormat = newFormat;
+}
+
+uint32_t BinaryLog::getDropped() const {
+    return dropped;
+}
+
+int32_t BinaryLog::parse(const uint8_t* data, size_t size, Record& record) {
+    if (size < 3) {
+        return size > 0 && data[0] != SYNC ? -1 : 0;
+    }
+    if (data[0] != SYNC || data[1] >= static_cast<uint8_t>(MessageID::NUM_MESSAGES) || data[2] > MAX_ARGS) {
+        return -1;
+    }
+
+    size_t frameSize = HEADER_SIZE + 4 * data[2] + 1;
+    if (size < frameSize) {
+        return 0;
+    }
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < frameSize - 1; i++) {
+        checksum += data[i];
+    }
+    if (checksum != data[frameSize - 1]) {
+        return -1;
+    }
+
+    record.id = static_cast<MessageID>(data[1]);
+    record.numArgs = data[2];
+    record.timestamp = readWord(&data[3]);
+    for (uint8_t arg = 0; arg < MAX_ARGS; arg++) {
+        record.args[arg] = arg < record.numArgs ? static_cast<int32_t>(readWord(&data[HEADER_SIZE + 4 * arg])) : 0;
+    }
+    return static_cast<int32_t>(frameSize);
+}
+
+size_t BinaryLog::format(const Record& record, char* line, size_t size) {
+    uint8_t index = static_cast<uint8_t>(record.id);
+    int length = snprintf(line, size, "[%lu] %s: ", static_cast<unsigned long>(record.timestamp), levelName(LEVELS[index]));
+
+    // Arguments the format does not use are ignored by snprintf
+    const int32_t* a = record.args;
+    if (length >= 0 && static_cast<size_t>(length) < size) {
+        length += snprintf(line + length, size - length, FORMATS[index],
+                           a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9], a[10]);
+    }
+    if (length < 0) {
+        length = 0;
+    }
+
+    // Always end on a full line, even if the message was cut short
+    size_t end = static_cast<size_t>(length) + 2 < size ? static_cast<size_t>(length) : size - 3;
+    line[end] = '\r';
+    line[end + 1] = '\n';
+    line[end + 2] = '\0';
+    return end + 2;
+}
+
+}// namespace PreCharge::log
@@ -0,0 +1,100 @@
+#include <PreCharge/CANDispatcher.hpp>
+
+#include <PreCharge/utils/CycleCounter.hpp>
+
+namespace PreCharge {
+
+void CANDispatcher::acceptStandard(uint16_t id) {
+    id &= 0x7FF;
+    standardMask[id >> 5] |= 1u << (id & 0x1F);
+}
+
+void CANDispatcher::setStandardHandler(Handler handler, void* priv) {
+    standardPriv = priv;
+    standardHandler = handler;
+}
+
+bool CANDispatcher::addExtended(uint32_t id, Handler handler, void* priv) {
+    if (handler == nullptr) {
+        return false;
+    }
+    id &= 0x1FFFFFFF;
+
+    uint8_t index = hash(id);
+    for (uint8_t probe = 0; probe < HASH_SIZE; probe++) {
+        Slot& slot = slots[(index + probe) % HASH_SIZE];
+        if (slot.handler != nullptr && slot.id != id) {
+            continue;
+        }
+        if (slot.handler == nullptr) {
+            if (numExtended == MAX_EXTENDED_IDS) {
+                return false;
+            }
+            numExtended++;
+        }
+        slot.id = id;
+        slot.priv = priv;
+        slot.handler = handler;
+        if (probe + 1 > maxProbe) {
+            maxProbe = probe + 1;
+        }
+        return true;
+    }
+    return false;
+}
+
+void CANDispatcher::dispatch(IO::CANMessage& message) {
+    uint32_t start = CycleCounter::now();
+    stats.received++;
+
+    uint32_t id = message.getId();
+    Handler handler = nullptr;
+    void* priv = nullptr;
+
+    if (message.isCANExtended()) {
+        id &= 0x1FFFFFFF;
+        uint8_t index = hash(id);
+        for (uint8_t probe = 0; probe < maxProbe; probe++) {
+            const Slot& slot = slots[(index + probe) % HASH_SIZE];
+            if (slot.handler == nullptr) {
+                break;
+            }
+            if (slot.id == id) {
+                handler = slot.handler;
+                priv = slot.priv;
+                stats.extended++;
+                break;
+            }
+        }
+    } else {
+        id &= 0x7FF;
+        if (standardHandler != nullptr && (standardMask[id >> 5] & (1u << (id & 0x1F)))) {
+            handler = standardHandler;
+            priv = standardPriv;
+            stats.standard++;
+        }
+    }
+
+    if (handler != nullptr) {
+        handler(message, priv);
+    } else {
+        stats.rejected++;
+    }
+
+    dispatchStats.record(CycleCounter::now() - start);
+}
+
+const CANDispatcher::Stats& CANDispatcher::getStats() const {
+    return stats;
+}
+
+const CycleStats& CANDispatcher::getDispatchStats() const {
+    return dispatchStats;
+}
+
+uint8_t CANDispatcher::hash(uint32_t id) {
+    // Fibonacci hashing, the top bits of the product are well mixed
+    return (id * 2654435761u) >> (32 - HASH_BITS);
+}
+
+}// namespace PreCharge
@@ -0,0 +1,83 @@
+#include <PreCharge/CANTxQueue.hpp>
+
+#include <PreCharge/utils/CycleCounter.hpp>
+
+#ifdef USE_HAL_DRIVER
+    #include <HALf3/stm32f3xx.h>
+#endif
+
+namespace PreCharge {
+
+CANTxQueue::CANTxQueue(IO::CAN& can) : can(can) {}
+
+bool CANTxQueue::enqueue(IO::CANMessage& message, Priority priority, bool coalesce) {
+    uint8_t p = static_cast<uint8_t>(priority);
+
+    if (coalesce) {
+        for (uint8_t i = 0; i < counts[p]; i++) {
+            Entry& entry = entries[p][(heads[p] + i) % CAPACITY];
+            if (entry.message.getId() == message.getId()
+                && entry.message.isCANExtended() == message.isCANExtended()) {
+                entry.message = message;
+                stats.coalesced++;
+                return true;
+            }
+        }
+    }
+
+    if (counts[p] == CAPACITY) {
+        stats.dropped++;
+        return false;
+    }
+
+    Entry& entry = entries[p][(heads[p] + counts[p]) % CAPACITY];
+    entry.message = message;
+    entry.enqueueTime = CycleCounter::now();
+    counts[p]++;
+
+    stats.depth++;
+    if (stats.depth > stats.maxDepth) {
+        stats.maxDepth = stats.depth;
+    }
+    return true;
+}
+
+uint8_t CANTxQueue::drain() {
+    uint8_t sent = 0;
+    for (uint8_t p = 0; p < NUM_PRIORITIES; p++) {
+        while (counts[p] > 0) {
+            Entry& entry = entries[p][heads[p]];
+            if (!mailboxFree() || can.transmit(entry.message) != IO::CAN::CANStatus::OK) {
+                // Mailboxes full, keep the frame for the next drain
+                return sent;
+            }
+            latency.record(CycleCounter::now() - entry.enqueueTime);
+
+            heads[p] = (heads[p] + 1) % CAPACITY;
+            counts[p]--;
+            stats.depth--;
+            stats.sent++;
+            sent++;
+        }
+    }
+    return sent;
+}
+
+const CANTxQueue::Stats& CANTxQueue::getStats() const {
+    return stats;
+}
+
+const CycleStats& CANTxQueue::getLatencyStats() const {
+    return latency;
+}
+
+bool CANTxQueue::mailboxFree() {
+#ifdef USE_HAL_DRIVER
+    return (CAN->TSR & (CAN_TSR_TME0 | CAN_TSR_TME1 | CAN_TSR_TME2)) != 0;
+#else
+    // The host CAN interfaces refuse a frame with a status instead
+    return true;
+#endif
+}
+
+}// namespace PreCharge
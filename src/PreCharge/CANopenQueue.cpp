@@ -0,0 +1,72 @@
+#include <PreCharge/CANopenQueue.hpp>
+
+#include <cstring>
+
+namespace PreCharge {
+
+CANopenQueue* CANopenQueue::driverQueue = nullptr;
+IO::CAN* CANopenQueue::driverCAN = nullptr;
+
+bool CANopenQueue::push(IO::CANMessage& message) {
+    Frame frame;
+    uint8_t length = message.getDataLength() > 8 ? 8 : message.getDataLength();
+    frame.header = static_cast<uint16_t>(((message.getId() & 0x7FF) << 4) | length);
+    memcpy(frame.data, message.getPayload(), 8);
+    return queue.push(frame);
+}
+
+bool CANopenQueue::pop(CO_IF_FRM* frame) {
+    Frame queued;
+    if (!queue.pop(queued)) {
+        return false;
+    }
+    frame->Identifier = queued.header >> 4;
+    frame->DLC = queued.header & 0x0F;
+    memcpy(frame->Data, queued.data, 8);
+    return true;
+}
+
+const CANopenQueue::Stats& CANopenQueue::getStats() const {
+    return queue.getStats();
+}
+
+void CANopenQueue::getDriver(IO::CAN& can, CO_IF_CAN_DRV* driver) {
+    driverQueue = this;
+    driverCAN = &can;
+
+    driver->Init = driverInit;
+    driver->Enable = driverEnable;
+    driver->Send = driverSend;
+    driver->Read = driverRead;
+    driver->Reset = driverReset;
+    driver->Close = driverClose;
+}
+
+void CANopenQueue::canHandler(IO::CANMessage& message, void* priv) {
+    static_cast<CANopenQueue*>(priv)->push(message);
+}
+
+void CANopenQueue::driverInit() {}
+
+void CANopenQueue::driverEnable(uint32_t baudrate) {}
+
+int16_t CANopenQueue::driverSend(CO_IF_FRM* frame) {
+    IO::CANMessage message(frame->Identifier, frame->DLC, frame->Data, false);
+    if (driverCAN == nullptr || driverCAN->transmit(message) != IO::CAN::CANStatus::OK) {
+        return -1;
+    }
+    return sizeof(CO_IF_FRM);
+}
+
+int16_t CANopenQueue::driverRead(CO_IF_FRM* frame) {
+    if (driverQueue == nullptr || !driverQueue->pop(frame)) {
+        return 0;
+    }
+    return sizeof(CO_IF_FRM);
+}
+
+void CANopenQueue::driverReset() {}
+
+void CANopenQueue::driverClose() {}
+
+}// namespace PreCharge
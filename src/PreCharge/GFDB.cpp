@@ -9,7 +9,7 @@ GFDB::GFDB(IO::CAN& can) : can(can){};
 
 IO::CAN::CANStatus GFDB::requestVoltagePositiveHighRes(int32_t* highRes) {
     uint8_t rxBuffer[8] = {};
-    IO::CAN::CANStatus result = requestData(VN_HIGH_RES_CMD, rxBuffer, 8);
+    IO::CAN::CANStatus result = requestData(VN_HIGH_RES_CMD, rxBuffer, RESPONSE_SIZE);
     if (result == IO::CAN::CANStatus::ERROR)
         return result;
 
@@ -19,7 +19,7 @@ IO::CAN::CANStatus GFDB::requestVoltagePositiveHighRes(int32_t* highRes) {
 
 IO::CAN::CANStatus GFDB::requestVoltageNegativeHighRes(int32_t* highRes) {
     uint8_t rxBuffer[8] = {};
-    IO::CAN::CANStatus result = requestData(VP_HIGH_RES_CMD, rxBuffer, 8);
+    IO::CAN::CANStatus result = requestData(VP_HIGH_RES_CMD, rxBuffer, RESPONSE_SIZE);
     if (result == IO::CAN::CANStatus::ERROR)
         return result;
 
@@ -42,7 +42,7 @@ IO::CAN::CANStatus GFDB::requestTemp(int32_t* temperature) {
 IO::CAN::CANStatus GFDB::requestIsolationState(uint8_t* isoState) {
     uint8_t buf[8];
 
-    IO::CAN::CANStatus result = requestData(ISO_STATE_REQ_CMD, buf, 8);
+    IO::CAN::CANStatus result = requestData(ISO_STATE_REQ_CMD, buf, RESPONSE_SIZE);
     if (result != IO::CAN::CANStatus::OK) {
         return result;
     }
@@ -52,17 +52,17 @@ IO::CAN::CANStatus GFDB::requestIsolationState(uint8_t* isoState) {
 }
 
 IO::CAN::CANStatus GFDB::requestIsolationResistances(uint8_t* resistances) {
-    return requestData(ISO_RESISTANCES_REQ_CMD, resistances, 8);
+    return requestData(ISO_RESISTANCES_REQ_CMD, resistances, RESPONSE_SIZE);
 }
 
 IO::CAN::CANStatus GFDB::requestIsolationCapacitances(uint8_t* capacitances) {
-    return requestData(ISO_CAPACITANCES_REQ_CMD, capacitances, 8);
+    return requestData(ISO_CAPACITANCES_REQ_CMD, capacitances, RESPONSE_SIZE);
 }
 
 IO::CAN::CANStatus GFDB::requestVoltagesPositiveNegative(uint16_t* voltageP, uint16_t* voltageN) {
     uint8_t rxBuffer[8] = {};
 
-    IO::CAN::CANStatus result = requestData(VP_VN_REQ_CMD, rxBuffer, 8);
+    IO::CAN::CANStatus result = requestData(VP_VN_REQ_CMD, rxBuffer, RESPONSE_SIZE);
     if (result == IO::CAN::CANStatus::ERROR)
         return result;
 
@@ -74,7 +74,7 @@ IO::CAN::CANStatus GFDB::requestVoltagesPositiveNegative(uint16_t* voltageP, uin
 
 IO::CAN::CANStatus GFDB::requestBatteryVoltage(uint16_t* batteryVoltage) {
     uint8_t rxBuffer[8] = {};
-    IO::CAN::CANStatus result = requestData(BATTERY_VOLTAGE_REQ_CMD, rxBuffer, 8);
+    IO::CAN::CANStatus result = requestData(BATTERY_VOLTAGE_REQ_CMD, rxBuffer, RESPONSE_SIZE);
     if (result == IO::CAN::CANStatus::ERROR) {
         return result;
     }
@@ -106,7 +106,189 @@ IO::CAN::CANStatus GFDB::setMaxBatteryVoltage(uint16_t maxVoltage) {
     return sendCommand(SET_MAX_VOLTAGE_CMD, payload, 4);
 }
 
+IO::CAN::CANStatus GFDB::queueRequest(uint8_t command, ResponseCallback callback, void* priv, uint32_t timeout) {
+    uint8_t index = findRequest(command);
+    if (index < MAX_PENDING_REQUESTS && requests[index].status == RequestStatus::PENDING) {
+        return IO::CAN::CANStatus::OK;
+    }
+
+    // Reuse the slot of an uncollected result for the same command
+    if (index == MAX_PENDING_REQUESTS) {
+        for (index = 0; index < MAX_PENDING_REQUESTS; index++) {
+            if (requests[index].status == RequestStatus::IDLE) {
+                break;
+            }
+        }
+        if (index == MAX_PENDING_REQUESTS) {
+            return IO::CAN::CANStatus::ERROR;
+        }
+    }
+
+    Request& request = requests[index];
+    request.command = command;
+    request.sent = false;
+    request.startTime = time::millis();
+    request.timeout = timeout;
+    request.callback = callback;
+    request.priv = priv;
+    request.status = RequestStatus::PENDING;
+
+    return IO::CAN::CANStatus::OK;
+}
+
+RequestStatus GFDB::pollResponse(uint8_t command, uint8_t* receiveBuff, uint8_t receiveSize) {
+    uint8_t index = findRequest(command);
+    if (index == MAX_PENDING_REQUESTS) {
+        return RequestStatus::IDLE;
+    }
+
+    Request& request = requests[index];
+    RequestStatus status = request.status;
+    if (status == RequestStatus::READY) {
+        for (uint8_t i = 0; i < receiveSize && i < RESPONSE_SIZE; i++) {
+            receiveBuff[i] = request.payload[i];
+        }
+    }
+    if (status != RequestStatus::PENDING) {
+        request.status = RequestStatus::IDLE;
+    }
+
+    return status;
+}
+
+void GFDB::process() {
+    uint32_t start = PreCharge::CycleCounter::now();
+    uint32_t now = time::millis();
+
+    // Expire requests whose response is overdue. The in flight request is
+    // detached from the interrupt first so a late response can't race it.
+    for (uint8_t i = 0; i < MAX_PENDING_REQUESTS; i++) {
+        Request& request = requests[i];
+        if (request.status != RequestStatus::PENDING || now - request.startTime <= request.timeout) {
+            continue;
+        }
+
+        if (inFlight == i) {
+            inFlight = MAX_PENDING_REQUESTS;
+        }
+        if (request.status == RequestStatus::PENDING) {
+            request.status = RequestStatus::TIMEOUT;
+            stats.timeouts++;
+        }
+    }
+
+    // Put the next queued request on the bus
+    if (inFlight == MAX_PENDING_REQUESTS) {
+        for (uint8_t i = 0; i < MAX_PENDING_REQUESTS; i++) {
+            uint8_t index = (nextSlot + i) % MAX_PENDING_REQUESTS;
+            Request& request = requests[index];
+            if (request.status != RequestStatus::PENDING || request.sent) {
+                continue;
+            }
+
+            nextSlot = (index + 1) % MAX_PENDING_REQUESTS;
+            request.sent = true;
+            request.startTime = now;
+            inFlight = index;
+
+            IO::CANMessage txMessage(GFDB_ID, 1, &request.command, true);
+            if (send(txMessage) != IO::CAN::CANStatus::OK) {
+                // Try again on the next call until the request times out
+                inFlight = MAX_PENDING_REQUESTS;
+                request.sent = false;
+            } else {
+                stats.requests++;
+            }
+            break;
+        }
+    }
+
+    // Hand completed requests to their callbacks
+    for (uint8_t i = 0; i < MAX_PENDING_REQUESTS; i++) {
+        Request& request = requests[i];
+        RequestStatus status = request.status;
+        if (request.callback == nullptr || (status != RequestStatus::READY && status != RequestStatus::TIMEOUT)) {
+            continue;
+        }
+
+        // Release the slot before the callback so it can queue the next request
+        uint8_t payload[RESPONSE_SIZE];
+        for (uint8_t j = 0; j < RESPONSE_SIZE; j++) {
+            payload[j] = request.payload[j];
+        }
+        ResponseCallback callback = request.callback;
+        request.status = RequestStatus::IDLE;
+
+        callback(request.command, status, status == RequestStatus::READY ? payload : nullptr, request.priv);
+    }
+
+    processStats.record(PreCharge::CycleCounter::now() - start);
+}
+
+bool GFDB::handleCANMessage(IO::CANMessage& message) {
+    // A response echoes the command and then carries RESPONSE_SIZE bytes.
+    // Anything shorter is rejected, so the payload is never read past its length
+    if (!message.isCANExtended() || message.getId() != GFDB_ID - 1 || message.getDataLength() < 1 + RESPONSE_SIZE) {
+        return false;
+    }
+
+    uint8_t index = inFlight;
+    if (index == MAX_PENDING_REQUESTS) {
+        return false;
+    }
+
+    Request& request = requests[index];
+    if (request.status != RequestStatus::PENDING || message.getPayload()[0] != request.command) {
+        return false;
+    }
+
+    // Skip the first byte because it's just the command repeated back
+    for (uint8_t i = 0; i < RESPONSE_SIZE; i++) {
+        request.payload[i] = message.getPayload()[i + 1];
+    }
+
+    uint32_t latency = time::millis() - request.startTime;
+    stats.responses++;
+    stats.lastLatency = latency;
+    if (latency > stats.maxLatency) {
+        stats.maxLatency = latency;
+    }
+
+    request.status = RequestStatus::READY;
+    inFlight = MAX_PENDING_REQUESTS;
+    return true;
+}
+
+GFDB::RequestStats GFDB::getRequestStats() const {
+    return stats;
+}
+
+uint32_t GFDB::getResponseID() const {
+    return GFDB_ID - 1;
+}
+
+void GFDB::setTxQueue(PreCharge::CANTxQueue* queue) {
+    txQueue = queue;
+}
+
+const PreCharge::CycleStats& GFDB::getProcessStats() const {
+    return processStats;
+}
+
+uint8_t GFDB::findRequest(uint8_t command) const {
+    for (uint8_t i = 0; i < MAX_PENDING_REQUESTS; i++) {
+        if (requests[i].status != RequestStatus::IDLE && requests[i].command == command) {
+            return i;
+        }
+    }
+    return MAX_PENDING_REQUESTS;
+}
+
 IO::CAN::CANStatus GFDB::requestData(uint8_t command, uint8_t* receiveBuff, uint8_t receiveSize) {
+    // Only RESPONSE_SIZE bytes follow the echoed command in a frame
+    if (receiveSize > RESPONSE_SIZE) {
+        receiveSize = RESPONSE_SIZE;
+    }
     IO::CANMessage txMessage(GFDB_ID, 1, &command, true);
 
     IO::CAN::CANStatus result;
@@ -123,12 +305,14 @@ IO::CAN::CANStatus GFDB::requestData(uint8_t command, uint8_t* receiveBuff, uint
             return result;
         }
 
-        if (rxMessage.getPayload()[0] == command && rxMessage.getId() == GFDB_ID - 1) {
+        if (rxMessage.getId() == GFDB_ID - 1 && rxMessage.getDataLength() >= 1 + receiveSize
+            && rxMessage.getPayload()[0] == command) {
             break;
         }
     }
 
-    if (rxMessage.getPayload()[0] != command || rxMessage.getId() != GFDB_ID - 1) {
+    if (rxMessage.getId() != GFDB_ID - 1 || rxMessage.getDataLength() < 1 + receiveSize
+        || rxMessage.getPayload()[0] != command) {
         return IO::CAN::CANStatus::ERROR;
     }
 
@@ -143,7 +327,18 @@ IO::CAN::CANStatus GFDB::requestData(uint8_t command, uint8_t* receiveBuff, uint
 IO::CAN::CANStatus GFDB::sendCommand(uint8_t command, uint8_t* payload, size_t payloadSize) {
     // TODO: This line does not look like it functions as intended
     IO::CANMessage txMessage(GFDB_ID, payloadSize, &command, true);
-    return can.transmit(txMessage);
+    return send(txMessage);
+}
+
+IO::CAN::CANStatus GFDB::send(IO::CANMessage& message) {
+    if (txQueue == nullptr) {
+        return can.transmit(message);
+    }
+    // Requests share one ID, so they are never coalesced
+    if (!txQueue->enqueue(message, PreCharge::CANTxQueue::Priority::DIAGNOSTIC, false)) {
+        return IO::CAN::CANStatus::ERROR;
+    }
+    return IO::CAN::CANStatus::OK;
 }
 
 };// namespace GFDB
@@ -0,0 +1,119 @@
+#include <PreCharge/GFDBPoller.hpp>
+
+#include <EVT/utils/time.hpp>
+
+namespace time = EVT::core::time;
+
+namespace GFDB {
+
+/** GFDB command used to read each field, indexed by GFDBPoller::Field */
+static const uint8_t FIELD_COMMANDS[GFDBPoller::NUM_FIELDS] = {
+    ISO_STATE_REQ_CMD,
+    ISO_RESISTANCES_REQ_CMD,
+    ISO_CAPACITANCES_REQ_CMD,
+    VP_VN_REQ_CMD,
+    BATTERY_VOLTAGE_REQ_CMD,
+    TEMP_REQ_CMD,
+    ERROR_FLAGS_REQ_CMD,
+};
+
+GFDBPoller::GFDBPoller(GFDB& gfdb) : gfdb(gfdb) {
+    uint32_t now = time::millis();
+    for (uint8_t i = 0; i < NUM_FIELDS; i++) {
+        period[i] = i == ISOLATION_STATE ? ISOLATION_STATE_PERIOD : DIAGNOSTIC_PERIOD;
+        // Make every field due on the first call to process()
+        lastRequest[i] = now - period[i];
+    }
+}
+
+void GFDBPoller::setPeriod(Field field, uint32_t period) {
+    this->period[field] = period;
+}
+
+void GFDBPoller::refresh() {
+    uint32_t now = time::millis();
+
+    // Start from the field after the last one queued so that when the GFDB
+    // runs out of slots the fields still take turns
+    uint8_t start = nextField;
+    for (uint8_t i = 0; i < NUM_FIELDS; i++) {
+        uint8_t field = (start + i) % NUM_FIELDS;
+        if (period[field] == 0 || (pendingMask & (1 << field)) || now - lastRequest[field] < period[field]) {
+            continue;
+        }
+
+        if (gfdb.queueRequest(FIELD_COMMANDS[field], responseCallback, this) != IO::CAN::CANStatus::OK) {
+            break;
+        }
+        pendingMask |= 1 << field;
+        lastRequest[field] = now;
+        nextField = (field + 1) % NUM_FIELDS;
+    }
+}
+
+void GFDBPoller::process() {
+    refresh();
+    gfdb.process();
+}
+
+const GFDBPoller::Snapshot& GFDBPoller::getSnapshot() const {
+    return snapshot;
+}
+
+bool GFDBPoller::isFresh(Field field, uint32_t maxAge) const {
+    return (snapshot.validMask & (1 << field)) && time::millis() - snapshot.timestamp[field] <= maxAge;
+}
+
+void GFDBPoller::responseCallback(uint8_t command, RequestStatus status, const uint8_t* payload, void* priv) {
+    auto* poller = static_cast<GFDBPoller*>(priv);
+
+    uint8_t field = 0;
+    while (field < NUM_FIELDS && FIELD_COMMANDS[field] != command) {
+        field++;
+    }
+    if (field == NUM_FIELDS) {
+        return;
+    }
+
+    poller->pendingMask &= ~(1 << field);
+    if (status != RequestStatus::READY) {
+        return;
+    }
+
+    Snapshot& snapshot = poller->snapshot;
+    switch (field) {
+    case ISOLATION_STATE:
+        snapshot.isolationState = payload[0] & 0x03;
+        break;
+    case ISOLATION_RESISTANCES:
+        for (uint8_t i = 0; i < GFDB::RESPONSE_SIZE; i++) {
+            snapshot.isolationResistances[i] = payload[i];
+        }
+        break;
+    case ISOLATION_CAPACITANCES:
+        for (uint8_t i = 0; i < GFDB::RESPONSE_SIZE; i++) {
+            snapshot.isolationCapacitances[i] = payload[i];
+        }
+        break;
+    case VOLTAGES_POSITIVE_NEGATIVE:
+        snapshot.voltageP = payload[2] << 8 | payload[3];
+        snapshot.voltageN = payload[5] << 8 | payload[6];
+        break;
+    case BATTERY_VOLTAGE:
+        snapshot.batteryVoltage = payload[2] << 8 | payload[3];
+        break;
+    case TEMPERATURE:
+        snapshot.temperature = (payload[0] << 24) | (payload[1] << 16) | (payload[2] << 8) | payload[3];
+        break;
+    case ERROR_FLAGS:
+        snapshot.errorFlags = payload[0];
+        break;
+    default:
+        break;
+    }
+
+    snapshot.timestamp[field] = time::millis();
+    snapshot.validMask |= 1 << field;
+}
+
+}// namespace GFDB
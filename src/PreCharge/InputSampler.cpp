@@ -0,0 +1,83 @@
+#include <PreCharge/InputSampler.hpp>
+
+#ifdef USE_HAL_DRIVER
+    #include <HALf3/stm32f3xx.h>
+#endif
+
+namespace PreCharge {
+
+void InputSampler::addInput(uint8_t bit, IO::GPIO& gpio, IO::Pin pin, Filter filter) {
+    if (bit >= MAX_INPUTS) {
+        return;
+    }
+    // IO::Pin is the port in the high nibble and the pin in the low one
+    gpios[bit] = &gpio;
+    ports[bit] = static_cast<uint8_t>(pin) >> 4;
+    pins[bit] = static_cast<uint8_t>(pin) & 0x0F;
+    inputMask |= 1u << bit;
+    if (filter == Filter::DEBOUNCE) {
+        debounceMask |= 1u << bit;
+    } else {
+        debounceMask &= ~(1u << bit);
+    }
+    if (ports[bit] < NUM_PORTS) {
+        portMask |= 1u << ports[bit];
+    }
+}
+
+uint32_t InputSampler::sample() {
+    uint32_t raw = read();
+    if (!primed) {
+        primed = true;
+        snapshot = raw;
+        return snapshot;
+    }
+
+    // LOW is taken at once, which also clears the input's counter below
+    snapshot &= raw | ~debounceMask;
+
+    // Count up every input that differs from the snapshot, reset the rest.
+    // An input flips once its counter wraps back to 0.
+    uint32_t delta = (raw ^ snapshot) & debounceMask;
+    count1 = (count1 ^ count0) & delta;
+    count0 = ~count0 & delta;
+    snapshot ^= delta & ~(count0 | count1);
+
+    snapshot = (snapshot & debounceMask) | (raw & ~debounceMask);
+    return snapshot;
+}
+
+uint32_t InputSampler::getSnapshot() const {
+    return snapshot;
+}
+
+IO::GPIO::State InputSampler::get(uint8_t bit) const {
+    return (snapshot >> bit) & 1u ? IO::GPIO::State::HIGH : IO::GPIO::State::LOW;
+}
+
+uint32_t InputSampler::read() {
+    uint32_t raw = 0;
+#ifdef USE_HAL_DRIVER
+    // One register read per port, the pins are then picked out of it
+    uint32_t portState[NUM_PORTS] = {};
+    for (uint8_t port = 0; port < NUM_PORTS; port++) {
+        if (portMask & (1u << port)) {
+            portState[port] = reinterpret_cast<GPIO_TypeDef*>(GPIOA_BASE + port * (GPIOB_BASE - GPIOA_BASE))->IDR;
+        }
+    }
+    for (uint8_t bit = 0; bit < MAX_INPUTS; bit++) {
+        if ((inputMask & (1u << bit)) && ports[bit] < NUM_PORTS) {
+            raw |= ((portState[ports[bit]] >> pins[bit]) & 1u) << bit;
+        }
+    }
+#else
+    for (uint8_t bit = 0; bit < MAX_INPUTS; bit++) {
+        if ((inputMask & (1u << bit)) && gpios[bit]->readPin() == IO::GPIO::State::HIGH) {
+            raw |= 1u << bit;
+        }
+    }
+#endif
+    return raw;
+}
+
+}// namespace PreCharge
@@ -1,7 +1,7 @@
 #include <PreCharge/PreCharge.hpp>
 
-#include <EVT/utils/log.hpp>
 #include <EVT/utils/time.hpp>
+#include <PreCharge/BinaryLog.hpp>
 
 namespace IO = EVT::core::IO;
 namespace time = EVT::core::time;
@@ -9,363 +9,209 @@ namespace time = EVT::core::time;
 namespace PreCharge {
 
 PreCharge::PreCharge(IO::GPIO& key, IO::GPIO& batteryOne, IO::GPIO& batteryTwo,
-                     IO::GPIO& eStop, IO::GPIO& pc, IO::GPIO& dc, Contactor cont,
-                     IO::GPIO& apm, GFDB::GFDB& gfdb, IO::CAN& can, MAX22530 MAX) : key(key),
-                                                                                    batteryOne(batteryOne),
-                                                                                    batteryTwo(batteryTwo),
-                                                                                    eStop(eStop),
-                                                                                    pc(pc),
-                                                                                    dc(dc),
-                                                                                    cont(cont),
-                                                                                    apm(apm),
-                                                                                    gfdb(gfdb),
-                                                                                    can(can),
-                                                                                    MAX(MAX) {
-    state = State::MC_OFF;
-    prevState = State::MC_OFF;
-
-    keyInStatus = IO::GPIO::State::LOW;
-    stoStatus = IO::GPIO::State::LOW;
-    batteryOneOkStatus = IO::GPIO::State::LOW;
-    batteryTwoOkStatus = IO::GPIO::State::LOW;
-    eStopActiveStatus = IO::GPIO::State::HIGH;
-    pcStatus = IO::GPIO::State::LOW;
-    dcStatus = IO::GPIO::State::LOW;
-    contStatus = 0;
-    voltStatus = 0;
-    apmStatus = IO::GPIO::State::LOW;
-
-    gfdStatus = 1;
+                     IO::GPIO& eStop, IO::GPIO& pc, IO::GPIO& dc, Contactor& cont,
+                     IO::GPIO& apm, GFDB::GFDB& gfdb, IO::CAN& can, MAX22530 MAX) : PreChargeCore<PreCharge>(key, batteryOne, batteryTwo, eStop, pc, dc, cont, apm, gfdb, can, MAX),
+                                                                                    sampler(this->MAX, ADC_CHANNELS) {
     initVolt = 0;
-
-    cycle_key = 0;
-    sendChangePDO();
 }
 
 PreCharge::PVCStatus PreCharge::handle() {
-    getSTO();     //update value of STO
-    getMCKey();   //update value of MC_KEY_IN
-    getIOStatus();//update value of IOStatus
-
-    Statusword = static_cast<uint8_t>(state);
-    InputVoltage = 0; //Does not exist yet
-    OutputVoltage = 0;//Does not exist yet
-    BasePTemp = 0;    //Does not exist yet
-
-    cyclicPDO = (InputVoltage << 32) | (OutputVoltage << 16) | BasePTemp;
-
-    switch (state) {
-    case PreCharge::State::MC_OFF:
-        mcOffState();
-        break;
-    case PreCharge::State::ESTOPWAIT:
-        eStopState();
-        break;
-    case PreCharge::State::PRECHARGE:
-        prechargeState();
-        break;
-    case PreCharge::State::CONT_CLOSE:
-        contCloseState();
-        break;
-    case PreCharge::State::MC_ON:
-        mcOnState();
-        break;
-    case PreCharge::State::CONT_OPEN:
-        contOpenState();
-        break;
-    case PreCharge::State::DISCHARGE:
-        dischargeState();
-        break;
-    case PreCharge::State::FORWARD_DISABLE:
-        forwardDisableState();
-        break;
-    default:
-        break;
-    }
+    handleADC();         //take the ADC sample this tick works from
+    gfdbPoller.process();//refresh the cached GFDB readings
 
-    if (cycle_key) {
-        return PVCStatus::PVC_ERROR;
-    } else {
-        return PVCStatus::PVC_OK;
-    }
+    return handleSafety();
 }
 
-void PreCharge::getSTO() {
-    if (in_precharge == 2 && time::millis() - lastPrechargeTime > 5000) {
-        uint8_t gfdBuffer;
-        IO::CAN::CANStatus gfdbConn = gfdb.requestIsolationState(&gfdBuffer);
-        //Error connecting to GFDB
-        if (gfdbConn == IO::CAN::CANStatus::OK && (gfdBuffer == 0b00 || gfdBuffer == 0b10)) {
-            gfdStatus = 1;
-        } else if (gfdBuffer == 0b11) {
-            EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::ERROR, "Bad GFDB");
-            gfdStatus = 0;
-        }
-    }
+void PreCharge::handleADC() {
+    updateSamples();
+}
 
-    batteryOneOkStatus = batteryOne.readPin();
-    batteryTwoOkStatus = batteryTwo.readPin();
-    eStopActiveStatus = eStop.readPin();
-    voltStatus = MAX.readVoltage(0x02) > MIN_PACK_VOLTAGE;
-
-    if (in_precharge == 2) {
-        if (batteryOneOkStatus == IO::GPIO::State::HIGH
-            && batteryTwoOkStatus == IO::GPIO::State::HIGH
-            && eStopActiveStatus == IO::GPIO::State::HIGH
-            && gfdStatus == 1
-            && voltStatus == 1) {
-            stoStatus = IO::GPIO::State::HIGH;
-            numAttemptsMade = 0;
-        } else {
-            // If ESTOP is active, stop immediately; otherwise, give the error attempts to clear
-            if (numAttemptsMade > MAX_STO_ATTEMPTS || eStopActiveStatus == IO::GPIO::State::LOW) {
-                EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::ERROR, "Too many fails, error out");
-                EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::ERROR, "1: %d, 2: %d, e: %d, g: %d", batteryOneOkStatus, batteryTwoOkStatus, eStopActiveStatus, gfdStatus);
-                cycle_key = 1;
-                stoStatus = IO::GPIO::State::LOW;
-                numAttemptsMade = 0;
-                return;
-            }
-            EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::ERROR, "1: %d, 2: %d, e: %d, g: %d", batteryOneOkStatus, batteryTwoOkStatus, eStopActiveStatus, gfdStatus);
+void PreCharge::handleGFDB() {
+    gfdbPoller.refresh();
+}
 
-            numAttemptsMade++;
-        }
-    } else {
-        if (batteryOneOkStatus == IO::GPIO::State::HIGH
-            && batteryTwoOkStatus == IO::GPIO::State::HIGH
-            && eStopActiveStatus == IO::GPIO::State::HIGH
-            && voltStatus == 1) {
-            stoStatus = IO::GPIO::State::HIGH;
-            numAttemptsMade = 0;
-        } else {
-            // If ESTOP is active, stop immediately; otherwise, give the error attempts to clear
-            if (numAttemptsMade > MAX_STO_ATTEMPTS || eStopActiveStatus == IO::GPIO::State::LOW) {
-                EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::ERROR, "Too many fails, error out");
-                EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::ERROR, "1: %d, 2: %d, e: %d", batteryOneOkStatus, batteryTwoOkStatus, eStopActiveStatus);
-                cycle_key = 1;
-                stoStatus = IO::GPIO::State::LOW;
-                numAttemptsMade = 0;
-                return;
-            }
-            EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::ERROR, "1: %d, 2: %d, e: %d", batteryOneOkStatus, batteryTwoOkStatus, eStopActiveStatus);
+PreCharge::PVCStatus PreCharge::handleSafety() {
+    cont.process();//end any contactor pulse that has run its course
 
-            numAttemptsMade++;
-        }
+    runStateMachine();
+
+    // However precharge was left, stop recording it
+    if (state != State::PRECHARGE) {
+        trace.finish(PrechargeTrace::Result::ABORTED);
+    }
+
+    if (cycle_key) {
+        return PVCStatus::PVC_ERROR;
+    } else {
+        return PVCStatus::PVC_OK;
     }
 }
 
 int PreCharge::getPrechargeStatus() {
     PrechargeStatus status;
     static uint64_t delta_time;
-    uint16_t pack_voltage;
-    uint16_t measured_voltage;
-    uint16_t expected_voltage;
 
     if (in_precharge == 0) {
         in_precharge = 1;
         state_start_time = time::millis();
-        initVolt = MAX.readVoltage(0x01);
-    }
-
-    delta_time = time::millis() - state_start_time;
-    measured_voltage = MAX.readVoltage(0x01);
-    pack_voltage = MAX.readVoltage(0x02);
-    expected_voltage = solveForVoltage(pack_voltage, delta_time);
-
-    if (measured_voltage >= (expected_voltage - 5) && measured_voltage <= (expected_voltage + 5) && pack_voltage > MIN_PACK_VOLTAGE) {
-        if (measured_voltage >= (pack_voltage - 1) && measured_voltage <= (pack_voltage + 1)) {
-            lastPrechargeTime = time::millis();
-            status = PrechargeStatus::DONE;
-            in_precharge = 2;
-        } else {
-            status = PrechargeStatus::OK;
+        initVolt = MAX.getMillivolts(adcSample, 0x01);
+        prechargeSampleStatus = PrechargeStatus::OK;
+        prechargeSampleChecked = false;
+        trace.start(state_start_time);
+        tauEstimator.start();
+        prechargeTimeSaved = 0;
+    }
+
+    // Only a sample updateSamples() has not checked yet is checked here.
+    // Samples taken before precharge started count as the start of the curve
+    if (!prechargeSampleChecked && prechargeSampleStatus == PrechargeStatus::OK) {
+        int32_t elapsed = static_cast<int32_t>(adcSampleTime - static_cast<uint32_t>(state_start_time));
+        delta_time = elapsed > 0 ? elapsed : 0;
+        prechargeSampleStatus = checkPrechargeSample(delta_time);
+        prechargeSampleChecked = true;
+    }
+    status = prechargeSampleStatus;
+
+    if (status == PrechargeStatus::DONE) {
+        lastPrechargeTime = time::millis();
+        in_precharge = 2;
+        trace.finish(PrechargeTrace::Result::DONE, prechargeTimeSaved > UINT16_MAX ? UINT16_MAX : prechargeTimeSaved);
+        lastTimeSaved = prechargeTimeSaved;
+        totalTimeSaved += prechargeTimeSaved;
+        if (prechargeTimeSaved > 0) {
+            log::LOGGER.log<log::MessageID::PRECHARGE_EARLY_DONE>(predictedInrush, prechargeTimeSaved);
         }
-    } else {
-        EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::ERROR, "Meas: %d, Exp: %d, Pack: %d", measured_voltage, expected_voltage, pack_voltage);
-        status = PrechargeStatus::ERROR;
+    } else if (status == PrechargeStatus::ERROR) {
         cycle_key = 1;
         in_precharge = 0;
+        trace.finish(PrechargeTrace::Result::ERROR);
     }
 
     return static_cast<int>(status);
 }
 
-uint16_t PreCharge::solveForVoltage(uint16_t pack_voltage, uint64_t delta_time) {
-    return initVolt + ((pack_voltage - initVolt) * (1 - exp(-(delta_time / (1000 * 30 * 0.014)))));
-}
+PreCharge::PrechargeStatus PreCharge::checkPrechargeSample(uint64_t delta_time) {
+    int32_t measured_voltage = MAX.getMillivolts(adcSample, 0x01);
+    int32_t pack_voltage = MAX.getMillivolts(adcSample, 0x02);
+    if (tauEstimator.addSample(delta_time, initVolt, measured_voltage, pack_voltage)) {
+        estimatedTau = tauEstimator.getTau();
+        estimatedCapacitance = estimatedTau * 1000 / CONST_R;
+    }
 
-void PreCharge::getMCKey() {
-    if (cycle_key) {
-        if (key.readPin() == IO::GPIO::State::LOW) {
-            cycle_key = 0;
+    int32_t expected_voltage = solveForVoltage(pack_voltage, delta_time);
+    PrechargeStatus status = PrechargeStatus::ERROR;
+
+    if (measured_voltage >= (expected_voltage - PRECHARGE_TOLERANCE_MV) && measured_voltage <= (expected_voltage + PRECHARGE_TOLERANCE_MV) && pack_voltage > MIN_PACK_MILLIVOLTS) {
+        if (measured_voltage >= (pack_voltage - PRECHARGE_DONE_MV) && measured_voltage <= (pack_voltage + PRECHARGE_DONE_MV)) {
+            status = PrechargeStatus::DONE;
+        } else if (canCloseEarly(measured_voltage, pack_voltage)) {
+            status = PrechargeStatus::DONE;
         } else {
-            keyInStatus = IO::GPIO::State::LOW;
+            status = PrechargeStatus::OK;
         }
-    } else {
-        keyInStatus = key.readPin();
     }
-}
 
-void PreCharge::getIOStatus() {
-    pcStatus = pc.readPin();
-    dcStatus = dc.readPin();
-    apmStatus = apm.readPin();
-}
+    trace.record(delta_time, measured_voltage, expected_voltage, pack_voltage, status != PrechargeStatus::OK);
 
-void PreCharge::setPrecharge(PreCharge::PinStatus state) {
-    if (static_cast<uint8_t>(state)) {
-        pc.writePin(IO::GPIO::State::HIGH);
-    } else {
-        pc.writePin(IO::GPIO::State::LOW);
+    if (status == PrechargeStatus::ERROR) {
+        log::LOGGER.log<log::MessageID::PRECHARGE_SAMPLE>(measured_voltage, expected_voltage, pack_voltage);
     }
+    return status;
 }
 
-void PreCharge::setDischarge(PreCharge::PinStatus state) {
-    if (static_cast<uint8_t>(state)) {
-        dc.writePin(IO::GPIO::State::HIGH);
-    } else {
-        dc.writePin(IO::GPIO::State::LOW);
+bool PreCharge::canCloseEarly(int32_t measured_voltage, int32_t pack_voltage) {
+    // Only extrapolate once this precharge's curve has been fitted. A
+    // rejected fit leaves an earlier precharge's scale, which says nothing
+    // about this one.
+    int32_t residual = pack_voltage - measured_voltage;
+    if (inrushLimit == 0 || !tauEstimator.hasFit() || residual <= 0) {
+        return false;
     }
-}
 
-void PreCharge::setAPM(PreCharge::PinStatus state) {
-    if (static_cast<uint8_t>(state)) {
-        apm.writePin(IO::GPIO::State::HIGH);
-    } else {
-        apm.writePin(IO::GPIO::State::LOW);
+    // What is left of the residual once the close pulse has run
+    uint32_t decay = (1u << PrechargeCurve::FRACTION_BITS) - PrechargeCurve::lookup(tauEstimator.scaleTime(Contactor::PULSE_DURATION));
+    int32_t atClose = static_cast<int32_t>((static_cast<int64_t>(residual) * decay) >> PrechargeCurve::FRACTION_BITS);
+    if (atClose > static_cast<int32_t>(inrushLimit)) {
+        return false;
     }
-}
 
-void PreCharge::mcOffState() {
-    in_precharge = 0;
-    if (stoStatus == IO::GPIO::State::LOW) {
-        state = State::ESTOPWAIT;
-        if (prevState != state) {
-            sendChangePDO();
-        }
-        prevState = state;
-    } else if (stoStatus == IO::GPIO::State::HIGH && keyInStatus == IO::GPIO::State::HIGH) {
-        state = State::PRECHARGE;
-        state_start_time = time::millis();
-        if (prevState != state) {
-            sendChangePDO();
-        }
-        prevState = state;
+    // Time the curve would have taken to decay into the done window:
+    // tau * ln(residual / PRECHARGE_DONE_MV), read off the nominal curve in
+    // 1/256 ms and scaled to the fitted tau
+    predictedInrush = atClose;
+    prechargeTimeSaved = 0;
+    if (residual > PRECHARGE_DONE_MV) {
+        uint32_t fraction = (1u << PrechargeCurve::FRACTION_BITS) - (static_cast<uint32_t>(PRECHARGE_DONE_MV) << PrechargeCurve::FRACTION_BITS) / residual;
+        uint64_t nominal = PrechargeCurve::invert(fraction > PrechargeCurve::FULL_SCALE ? PrechargeCurve::FULL_SCALE : fraction);
+        prechargeTimeSaved = static_cast<uint32_t>((nominal << 8) / tauEstimator.getScale());
     }
-    //else stay on MC_OFF
+    return true;
 }
 
-void PreCharge::mcOnState() {
-    if (stoStatus == IO::GPIO::State::LOW || keyInStatus == IO::GPIO::State::LOW) {
-        state = State::FORWARD_DISABLE;
-        if (prevState != state) {
-            sendChangePDO();
-        }
-        prevState = state;
-    }
-    //else stay on MC_ON
+MAX22530Sampler& PreCharge::getSampler() {
+    return sampler;
 }
 
-void PreCharge::eStopState() {
-    if (stoStatus == IO::GPIO::State::HIGH) {
-        state = State::MC_OFF;
-        if (prevState != state) {
-            sendChangePDO();
-        }
-        prevState = state;
-    }
-    // Else stay on E-Stop
-
-    // If E-stop is pressed and key is turned, send BMS reset message
-    // Need to reread key to get around cycle requirement
-    if (eStopActiveStatus == IO::GPIO::State::LOW && key.readPin() == IO::GPIO::State::HIGH) {
-        uint8_t payload[8] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
-        IO::CANMessage bmsResetMessage(0x7FF, 8, payload, false);
-        for (uint8_t i = 0; i < 5; i++) {
-            can.transmit(bmsResetMessage);
-        }
-    }
+const PrechargeTrace& PreCharge::getTrace() const {
+    return trace;
 }
 
-void PreCharge::prechargeState() {
-    setPrecharge(PreCharge::PinStatus::ENABLE);
-    int precharging = getPrechargeStatus();
+void PreCharge::updateSamples() {
+    if (sampler.isRunning()) {
+        MAX22530Sampler::TimedSample timedSample;
+        while (sampler.pop(timedSample)) {
+            adcSample = timedSample.sample;
+            adcSampleTime = timedSample.timestamp;
+            prechargeSampleChecked = false;
 
-    // Stay in prechargeState until DONE unless ERROR
-    if (precharging == static_cast<int>(PrechargeStatus::ERROR) || stoStatus == IO::GPIO::State::LOW || keyInStatus == IO::GPIO::State::LOW) {
-        EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::DEBUG, "Precharge error");
-        state = State::FORWARD_DISABLE;
-    } else if (precharging == static_cast<int>(PrechargeStatus::DONE)) {
-        EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::DEBUG, "Precharge done");
-        state = State::CONT_CLOSE;
-    }
-    if (prevState != state) {
-        sendChangePDO();
-    }
-    prevState = state;
-}
+            if (state == State::PRECHARGE && in_precharge == 1 && prechargeSampleStatus == PrechargeStatus::OK) {
+                int32_t elapsed = static_cast<int32_t>(adcSampleTime - static_cast<uint32_t>(state_start_time));
+                if (elapsed > 0) {
+                    prechargeSampleStatus = checkPrechargeSample(elapsed);
+                    prechargeSampleChecked = true;
+                }
+            }
+        }
 
-void PreCharge::dischargeState() {
-    setDischarge(PreCharge::PinStatus::ENABLE);
-    if ((time::millis() - state_start_time) > DISCHARGE_DELAY) {
-        setDischarge(PreCharge::PinStatus::DISABLE);
-        state = State::MC_OFF;
-    }
-    if (prevState != state) {
-        sendChangePDO();
+        // Counted from the start if the sampler has not delivered yet
+        uint32_t now = time::millis();
+        uint32_t age = now - adcSampleTime;
+        if (age <= ADC_MAX_AGE || now - sampler.getStartTime() <= ADC_MAX_AGE) {
+            return;
+        }
+        // Stopping it also hands the SPI bus back for the direct reads
+        sampler.stop();
+        log::LOGGER.log<log::MessageID::ADC_STALLED>(age, sampler.getErrorCount());
     }
-    prevState = state;
-}
 
-void PreCharge::contOpenState() {
-    cont.setOpen(true);
-    contStatus = 0;
-    state = State::DISCHARGE;
-    state_start_time = time::millis();
-    if (prevState != state) {
-        sendChangePDO();
+    MAX22530::Sample sample;
+    if (MAX.readChannels(ADC_CHANNELS, sample) == IO::SPI::SPIStatus::OK) {
+        adcSample = sample;
+        adcSampleTime = time::millis();
+        prechargeSampleChecked = false;
     }
-    prevState = state;
 }
 
-void PreCharge::contCloseState() {
-    cont.setOpen(false);
-    contStatus = 1;
-    setPrecharge(PreCharge::PinStatus::DISABLE);
-    if (stoStatus == IO::GPIO::State::LOW || keyInStatus == IO::GPIO::State::LOW) {
-        state = State::FORWARD_DISABLE;
-    } else if (stoStatus == IO::GPIO::State::HIGH && keyInStatus == IO::GPIO::State::HIGH) {
-        setAPM(PreCharge::PinStatus::ENABLE);
-
-        //CAN message to wake TMS
-        uint8_t payload[2] = {0x01, 0x08};
-        IO::CANMessage TMSOpMessage(0, 2, payload, false);
-        can.transmit(TMSOpMessage);
-
-        state = State::MC_ON;
-    }
-    if (prevState != state) {
-        sendChangePDO();
-    }
-    prevState = state;
+const PreCharge::PrechargeTauEstimator& PreCharge::getTauEstimator() const {
+    return tauEstimator;
 }
 
-void PreCharge::forwardDisableState() {
-    setPrecharge(PreCharge::PinStatus::DISABLE);
-    if ((time::millis() - state_start_time) > FORWARD_DISABLE_DELAY) {
-        setAPM(PreCharge::PinStatus::DISABLE);
+int32_t PreCharge::solveForVoltage(int32_t pack_voltage, uint64_t delta_time) {
+    return PrechargeCurve::solve(initVolt, pack_voltage, tauEstimator.scaleTime(delta_time));
+}
 
-        //CAN message to send TMS into pre-op state
-        uint8_t payload[2] = {0x80, 0x08};
-        IO::CANMessage TMSOpMessage(0, 2, payload, false);
-        can.transmit(TMSOpMessage);
+void PreCharge::prechargeState() {
+    setPrecharge(PreCharge::PinStatus::ENABLE);
+    int precharging = getPrechargeStatus();
 
-        state = State::CONT_OPEN;
-    }
-    if (prevState != state) {
-        sendChangePDO();
+    // Stay in prechargeState until DONE unless ERROR
+    if (precharging == static_cast<int>(PrechargeStatus::ERROR) || getStatus(STATUS_STO) == IO::GPIO::State::LOW || getStatus(STATUS_KEY) == IO::GPIO::State::LOW) {
+        log::LOGGER.log<log::MessageID::PRECHARGE_ERROR>();
+        enterForwardDisable();
+    } else if (precharging == static_cast<int>(PrechargeStatus::DONE)) {
+        log::LOGGER.log<log::MessageID::PRECHARGE_DONE>();
+        state = State::CONT_CLOSE;
     }
-    prevState = state;
 }
 
 CO_OBJ_T* PreCharge::getObjectDictionary() {
@@ -380,20 +226,4 @@ uint8_t PreCharge::getNodeID() {
     return NODE_ID;
 }
 
-void PreCharge::sendChangePDO() {
-    uint8_t payload[] = {
-        static_cast<uint8_t>(state),
-        0x00,
-        static_cast<unsigned short>(keyInStatus) << 4 | static_cast<unsigned short>(stoStatus),
-        static_cast<unsigned short>(batteryOneOkStatus) << 4 | static_cast<unsigned short>(batteryTwoOkStatus),
-        static_cast<unsigned short>(eStopActiveStatus) << 4 | static_cast<unsigned short>(apmStatus),
-        static_cast<unsigned short>(pcStatus) << 4 | static_cast<unsigned short>(dcStatus),
-        static_cast<unsigned short>(contStatus) << 4 | static_cast<unsigned short>(voltStatus)};
-    IO::CANMessage changePDOMessage(0x48A, 7, payload, false);
-    can.transmit(changePDOMessage);
-
-    EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::DEBUG, "s: %d, k: %d; sto: %d; b1: %d; b2: %d; e: %d; a: %d, pc: %d, dc: %d, c: %d, v: %d",
-                               state, keyInStatus, stoStatus, batteryOneOkStatus, batteryTwoOkStatus, eStopActiveStatus, apmStatus, pcStatus, dcStatus, contStatus, voltStatus);
-}
-
 }// namespace PreCharge
\ No newline at end of file
@@ -0,0 +1,488 @@
+#include <PreCharge/PreChargeCore.hpp>
+
+#include <EVT/utils/time.hpp>
+#include <PreCharge/BinaryLog.hpp>
+#include <PreCharge/PreCharge.hpp>
+#include <PreCharge/PreChargeKEV1N.hpp>
+
+#include <cstring>
+
+namespace IO = EVT::core::IO;
+namespace time = EVT::core::time;
+
+namespace PreCharge {
+
+template<typename Variant>
+PreChargeCore<Variant>::PreChargeCore(IO::GPIO& key, IO::GPIO& batteryOne, IO::GPIO& batteryTwo,
+                                      IO::GPIO& eStop, IO::GPIO& pc, IO::GPIO& dc, Contactor& cont,
+                                      IO::GPIO& apm, GFDB::GFDB& gfdb, IO::CAN& can, MAX22530 MAX) : key(key),
+                                                                                                     batteryOne(batteryOne),
+                                                                                                     batteryTwo(batteryTwo),
+                                                                                                     eStop(eStop),
+                                                                                                     pc(pc),
+                                                                                                     dc(dc),
+                                                                                                     cont(cont),
+                                                                                                     apm(apm),
+                                                                                                     gfdb(gfdb),
+                                                                                                     gfdbPoller(gfdb),
+                                                                                                     can(can),
+                                                                                                     txQueue(can),
+                                                                                                     MAX(MAX) {
+    state = State::MC_OFF;
+    state_start_time = 0;
+    in_precharge = 0;
+
+    CycleCounter::init();
+
+    inputs.addInput(INPUT_KEY, key, KEY_IN_PIN, InputSampler::Filter::DEBOUNCE);
+    inputs.addInput(INPUT_BATTERY_ONE, batteryOne, BAT_OK_1_PIN, InputSampler::Filter::DEBOUNCE);
+    inputs.addInput(INPUT_BATTERY_TWO, batteryTwo, BAT_OK_2_PIN, InputSampler::Filter::DEBOUNCE);
+    inputs.addInput(INPUT_ESTOP, eStop, ESTOP_IN_PIN, InputSampler::Filter::DEBOUNCE);
+    inputs.addInput(INPUT_PC, pc, PC_CTL_PIN, InputSampler::Filter::RAW);
+    inputs.addInput(INPUT_DC, dc, DC_CTL_PIN, InputSampler::Filter::RAW);
+    inputs.addInput(INPUT_APM, apm, APM_CTL_PIN, InputSampler::Filter::RAW);
+
+    // NMT, SYNC, RPDO0 and SDO requests, everything this node's object
+    // dictionary consumes. RPDO0 is only accepted for a variant with
+    // HAS_RPDO0. Its COB-ID is read only at 0x1400 sub-index 1, so its
+    // default is the only one it can arrive on. A new RPDO needs its COB-ID
+    // added here, and made read only the same way.
+    canDispatcher.acceptStandard(0x000);
+    canDispatcher.acceptStandard(0x080);
+    if (Variant::HAS_RPDO0) {
+        canDispatcher.acceptStandard(0x200 + NODE_ID);
+    }
+    canDispatcher.acceptStandard(0x600 + NODE_ID);
+    canDispatcher.setStandardHandler(CANopenQueue::canHandler, &canOpenQueue);
+    canDispatcher.addExtended(gfdb.getResponseID(), gfdbCANHandler, &gfdb);
+    gfdb.setTxQueue(&txQueue);
+
+    // MC_OFF, with everything off but the e-stop input
+    changePDO = 1ull << STATUS_ESTOP;
+    Statusword = static_cast<uint8_t>(state);
+
+    gfdStatus = 1;
+    lastPrechargeTime = 0;
+
+    cycle_key = 0;
+    sendChangePDO();
+    txQueue.drain();
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::runStateMachine() {
+    inputs.sample();//snapshot and debounce the IO
+
+    uint32_t start = CycleCounter::now();
+    getSTO();//update value of STO
+    stoStats.record(CycleCounter::now() - start);
+    getMCKey();   //update value of MC_KEY_IN
+    getIOStatus();//update value of IOStatus
+
+    if (eStopLatched) {
+        handleEStopLatch();
+    }
+
+    Statusword = static_cast<uint8_t>(state);
+    InputVoltage = 0; //Does not exist yet
+    OutputVoltage = 0;//Does not exist yet
+    BasePTemp = 0;    //Does not exist yet
+
+    cyclicPDO = (InputVoltage << 32) | (OutputVoltage << 16) | BasePTemp;
+
+    // Charged to the state the pass started in, transitions included
+    uint8_t index = static_cast<uint8_t>(state);
+    StateHandler handler = Variant::STATE_HANDLERS[index];
+    if (handler != nullptr) {
+        start = CycleCounter::now();
+        (static_cast<Variant*>(this)->*handler)();
+        stateStats[index].record(CycleCounter::now() - start);
+    }
+
+    // The IO status is already in changePDO, only the state is left
+    changePDO = (changePDO & ~(0xFFull << STATUS_STATE)) | static_cast<uint64_t>(state) << STATUS_STATE;
+    if ((changePDO ^ sentChangePDO) & changePDOTrigger & Variant::CHANGE_PDO_FIELDS) {
+        sendChangePDO();
+    }
+
+    // Put what the pass queued on the bus, as far as the mailboxes allow
+    txQueue.drain();
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::enableEStopInterrupt() {
+    eStop.registerIRQ(IO::GPIO::TriggerEdge::FALLING, eStopIRQHandler, this);
+}
+
+template<typename Variant>
+typename PreChargeCore<Variant>::EStopStats PreChargeCore<Variant>::getEStopStats() const {
+    return {
+        eStopCount,
+        CycleCounter::toNanoseconds(eStopLastTicks),
+        CycleCounter::toNanoseconds(eStopMaxTicks),
+    };
+}
+
+template<typename Variant>
+CANTxQueue& PreChargeCore<Variant>::getTxQueue() {
+    return txQueue;
+}
+
+template<typename Variant>
+CANDispatcher& PreChargeCore<Variant>::getCANDispatcher() {
+    return canDispatcher;
+}
+
+template<typename Variant>
+CANopenQueue& PreChargeCore<Variant>::getCANopenQueue() {
+    return canOpenQueue;
+}
+
+template<typename Variant>
+const typename PreChargeCore<Variant>::WaitStats& PreChargeCore<Variant>::getDischargeStats() const {
+    return dischargeStats;
+}
+
+template<typename Variant>
+const typename PreChargeCore<Variant>::WaitStats& PreChargeCore<Variant>::getForwardDisableStats() const {
+    return forwardDisableStats;
+}
+
+template<typename Variant>
+const CycleStats& PreChargeCore<Variant>::getStateStats(State s) const {
+    return stateStats[static_cast<uint8_t>(s)];
+}
+
+template<typename Variant>
+const CycleStats& PreChargeCore<Variant>::getSTOStats() const {
+    return stoStats;
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::eStopIRQHandler(IO::GPIO* pin, void* priv) {
+    uint32_t start = CycleCounter::now();
+    auto* core = static_cast<PreChargeCore*>(priv);
+
+    // Outputs first, everything else is left to the state machine
+    core->pc.writePin(IO::GPIO::State::LOW);
+    core->apm.writePin(IO::GPIO::State::LOW);
+    core->cont.emergencyOpen();
+    uint32_t ticks = CycleCounter::now() - start;
+
+    core->eStopLatched = true;
+    core->eStopCount++;
+    core->eStopLastTicks = ticks;
+    if (ticks > core->eStopMaxTicks) {
+        core->eStopMaxTicks = ticks;
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::gfdbCANHandler(IO::CANMessage& message, void* priv) {
+    // Anything that is not the awaited response is stale and dropped
+    static_cast<GFDB::GFDB*>(priv)->handleCANMessage(message);
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::handleEStopLatch() {
+    eStopLatched = false;
+    log::LOGGER.log<log::MessageID::ESTOP_INTERRUPT>(CycleCounter::toNanoseconds(eStopLastTicks));
+
+    // Same as a polled e-stop, except it holds even if the input bounced back
+    cycle_key = 1;
+    setStatus(STATUS_KEY, IO::GPIO::State::LOW);
+    setStatus(STATUS_STO, IO::GPIO::State::LOW);
+    setStatus(STATUS_CONT, 0);
+
+    switch (state) {
+    case State::MC_ON:
+    case State::FORWARD_DISABLE:
+        //CAN message to send TMS into pre-op state, as FORWARD_DISABLE would have
+        sendTMS(Variant::TMS_PRE_OP_PAYLOAD, sizeof(Variant::TMS_PRE_OP_PAYLOAD));
+        state = State::CONT_OPEN;
+        break;
+    case State::PRECHARGE:
+    case State::CONT_CLOSE:
+        state = State::CONT_OPEN;
+        break;
+    default:
+        // Contactor is already open or opening
+        break;
+    }
+}
+
+template<typename Variant>
+const GFDB::GFDBPoller::Snapshot& PreChargeCore<Variant>::getGFDBSnapshot() const {
+    return gfdbPoller.getSnapshot();
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::getSTO() {
+    if (in_precharge == 2 && time::millis() - lastPrechargeTime > 5000) {
+        // Fail safe if the isolation state has not been refreshed recently
+        if (!gfdbPoller.isFresh(GFDB::GFDBPoller::ISOLATION_STATE, GFDB_MAX_AGE)) {
+            if (gfdStatus == 1) {
+                log::LOGGER.log<log::MessageID::GFDB_STALE>();
+            }
+            gfdStatus = 0;
+        } else {
+            uint8_t isoState = gfdbPoller.getSnapshot().isolationState;
+            if (isoState == 0b00 || isoState == 0b10) {
+                gfdStatus = 1;
+            } else if (isoState == 0b11) {
+                if (gfdStatus == 1) {
+                    log::LOGGER.log<log::MessageID::GFDB_BAD>();
+                }
+                gfdStatus = 0;
+            }
+        }
+    }
+
+    setStatus(STATUS_BATTERY_ONE, inputs.get(INPUT_BATTERY_ONE));
+    setStatus(STATUS_BATTERY_TWO, inputs.get(INPUT_BATTERY_TWO));
+    setStatus(STATUS_ESTOP, inputs.get(INPUT_ESTOP));
+    setStatus(STATUS_VOLT, MAX.getMillivolts(adcSample, 0x02) > MIN_PACK_MILLIVOLTS);
+
+    // The isolation state only counts once precharge has completed
+    bool gfdOk = in_precharge != 2 || gfdStatus == 1;
+
+    if ((changePDO & STO_INPUTS) == STO_INPUTS && gfdOk) {
+        setStatus(STATUS_STO, IO::GPIO::State::HIGH);
+        numAttemptsMade = 0;
+        return;
+    }
+
+    // With the key cycle latch an active ESTOP stops immediately; otherwise,
+    // give the error attempts to clear
+    if (numAttemptsMade > MAX_STO_ATTEMPTS || (Variant::LATCH_KEY_CYCLE && getStatus(STATUS_ESTOP) == IO::GPIO::State::LOW)) {
+        log::LOGGER.log<log::MessageID::STO_FAULT>();
+        log::LOGGER.log<log::MessageID::STO_INPUTS>(getStatus(STATUS_BATTERY_ONE), getStatus(STATUS_BATTERY_TWO), getStatus(STATUS_ESTOP), gfdStatus);
+        if (Variant::LATCH_KEY_CYCLE) {
+            cycle_key = 1;
+        }
+        setStatus(STATUS_STO, IO::GPIO::State::LOW);
+        numAttemptsMade = 0;
+        return;
+    }
+    // Count at most one attempt per STO_ATTEMPT_PERIOD however often this runs
+    if (time::millis() - lastAttemptTime >= STO_ATTEMPT_PERIOD) {
+        lastAttemptTime = time::millis();
+        log::LOGGER.log<log::MessageID::STO_INPUTS>(getStatus(STATUS_BATTERY_ONE), getStatus(STATUS_BATTERY_TWO), getStatus(STATUS_ESTOP), gfdStatus);
+        numAttemptsMade++;
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::getMCKey() {
+    if (Variant::LATCH_KEY_CYCLE && cycle_key) {
+        if (inputs.get(INPUT_KEY) == IO::GPIO::State::LOW) {
+            cycle_key = 0;
+        } else {
+            setStatus(STATUS_KEY, IO::GPIO::State::LOW);
+        }
+    } else {
+        setStatus(STATUS_KEY, inputs.get(INPUT_KEY));
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::getIOStatus() {
+    setStatus(STATUS_PC, inputs.get(INPUT_PC));
+    setStatus(STATUS_DC, inputs.get(INPUT_DC));
+    setStatus(STATUS_APM, inputs.get(INPUT_APM));
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::setPrecharge(PinStatus state) {
+    // Never undo the e-stop interrupt before the state machine has seen it
+    if (static_cast<uint8_t>(state) && !eStopLatched) {
+        pc.writePin(IO::GPIO::State::HIGH);
+    } else {
+        pc.writePin(IO::GPIO::State::LOW);
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::setDischarge(PinStatus state) {
+    if (static_cast<uint8_t>(state)) {
+        dc.writePin(IO::GPIO::State::HIGH);
+    } else {
+        dc.writePin(IO::GPIO::State::LOW);
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::setAPM(PinStatus state) {
+    if (static_cast<uint8_t>(state) && !eStopLatched) {
+        apm.writePin(IO::GPIO::State::HIGH);
+    } else {
+        apm.writePin(IO::GPIO::State::LOW);
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::mcOffState() {
+    in_precharge = 0;
+    if (getStatus(STATUS_STO) == IO::GPIO::State::LOW) {
+        state = State::ESTOPWAIT;
+    } else if (getStatus(STATUS_STO) == IO::GPIO::State::HIGH && getStatus(STATUS_KEY) == IO::GPIO::State::HIGH) {
+        state = State::PRECHARGE;
+        state_start_time = time::millis();
+    }
+    //else stay on MC_OFF
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::mcOnState() {
+    if (getStatus(STATUS_STO) == IO::GPIO::State::LOW || getStatus(STATUS_KEY) == IO::GPIO::State::LOW) {
+        enterForwardDisable();
+    }
+    //else stay on MC_ON
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::eStopState() {
+    if (getStatus(STATUS_STO) == IO::GPIO::State::HIGH) {
+        state = State::MC_OFF;
+    }
+    // Else stay on E-Stop
+
+    // If E-stop is pressed and key is turned, send BMS reset message
+    // Use the key input itself to get around the cycle requirement
+    if (Variant::BMS_RESET_ON_ESTOP && getStatus(STATUS_ESTOP) == IO::GPIO::State::LOW
+        && inputs.get(INPUT_KEY) == IO::GPIO::State::HIGH
+        && time::millis() - lastBMSResetTime >= BMS_RESET_PERIOD) {
+        lastBMSResetTime = time::millis();
+        uint8_t payload[8] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+        IO::CANMessage bmsResetMessage(0x7FF, 8, payload, false);
+        for (uint8_t i = 0; i < 5; i++) {
+            txQueue.enqueue(bmsResetMessage, CANTxQueue::Priority::SAFETY, false);
+        }
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::dischargeState() {
+    setDischarge(PinStatus::ENABLE);
+    uint32_t now = time::millis();
+    uint32_t elapsed = now - static_cast<uint32_t>(state_start_time);
+
+    // Done once the output has stayed below the safe voltage for the
+    // debounce window, or at the latest after DISCHARGE_DELAY. Only samples
+    // taken since discharge started count, and the window runs on their
+    // timestamps, so a sample that stops updating cannot complete it. One
+    // older than the window resets it.
+    int32_t output = MAX.getMillivolts(adcSample, 0x01);
+    bool fresh = static_cast<int32_t>(adcSampleTime - static_cast<uint32_t>(state_start_time)) >= 0
+                 && now - adcSampleTime <= DISCHARGE_DEBOUNCE;
+    if (!fresh || output >= static_cast<int32_t>(dischargeSafeMillivolts)) {
+        dischargeSafe = false;
+    } else if (!dischargeSafe) {
+        dischargeSafe = true;
+        dischargeSafeTime = adcSampleTime;
+    }
+    bool discharged = dischargeSafe && adcSampleTime - dischargeSafeTime >= DISCHARGE_DEBOUNCE;
+
+    if (discharged || elapsed > DISCHARGE_DELAY) {
+        setDischarge(PinStatus::DISABLE);
+        state = State::MC_OFF;
+
+        dischargeSafe = false;
+        dischargeStats.record(elapsed, !discharged);
+        log::LOGGER.log<log::MessageID::DISCHARGE_DONE>(output, elapsed);
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::contOpenState() {
+    cont.requestOpen(true);
+    setStatus(STATUS_CONT, 0);
+    // Only start discharging once the open pulse has completed
+    if (cont.getActuation() == Contactor::Actuation::IDLE) {
+        state = State::DISCHARGE;
+        state_start_time = time::millis();
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::contCloseState() {
+    cont.requestOpen(false);
+    if (getStatus(STATUS_STO) == IO::GPIO::State::LOW || getStatus(STATUS_KEY) == IO::GPIO::State::LOW) {
+        enterForwardDisable();
+    } else if (cont.getActuation() != Contactor::Actuation::IDLE) {
+        // Keep precharging until the close pulse has completed
+    } else if (getStatus(STATUS_STO) == IO::GPIO::State::HIGH && getStatus(STATUS_KEY) == IO::GPIO::State::HIGH) {
+        setStatus(STATUS_CONT, 1);
+        setPrecharge(PinStatus::DISABLE);
+        setAPM(PinStatus::ENABLE);
+
+        //CAN message to wake TMS
+        sendTMS(Variant::TMS_WAKE_PAYLOAD, sizeof(Variant::TMS_WAKE_PAYLOAD));
+
+        state = State::MC_ON;
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::enterForwardDisable() {
+    state = State::FORWARD_DISABLE;
+    state_start_time = time::millis();
+    // Anything the motor controller sent before now does not count
+    mcStatus = mcDisabledValue ^ mcDisabledMask;
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::forwardDisableState() {
+    setPrecharge(PinStatus::DISABLE);
+    uint32_t elapsed = time::millis() - static_cast<uint32_t>(state_start_time);
+
+    // Done once the motor controller reports it is disabled, or at the
+    // latest after FORWARD_DISABLE_DELAY
+    bool confirmed = mcDisabledMask != 0 && (mcStatus & mcDisabledMask) == (mcDisabledValue & mcDisabledMask);
+
+    if (confirmed || elapsed > FORWARD_DISABLE_DELAY) {
+        forwardDisableStats.record(elapsed, !confirmed);
+        setAPM(PinStatus::DISABLE);
+
+        //CAN message to send TMS into pre-op state
+        sendTMS(Variant::TMS_PRE_OP_PAYLOAD, sizeof(Variant::TMS_PRE_OP_PAYLOAD));
+
+        state = State::CONT_OPEN;
+    }
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::sendTMS(const uint8_t* payload, uint8_t size) {
+    uint8_t data[8];
+    for (uint8_t i = 0; i < size; i++) {
+        data[i] = payload[i];
+    }
+    IO::CANMessage TMSOpMessage(0, size, data, false);
+    // Only the latest command matters to the TMS
+    txQueue.enqueue(TMSOpMessage, CANTxQueue::Priority::SAFETY, true);
+}
+
+template<typename Variant>
+void PreChargeCore<Variant>::sendChangePDO() {
+    // Both the STM32 and the host are little endian, so the bytes of the
+    // word are already in payload order
+    uint64_t word = changePDO & Variant::CHANGE_PDO_FIELDS;
+    if (Variant::CHANGE_PDO_PASS_STATE) {
+        word = (word & ~(0xFFull << STATUS_STATE)) | static_cast<uint64_t>(Statusword) << STATUS_STATE;
+    }
+    uint8_t payload[sizeof(word)];
+    memcpy(payload, &word, sizeof(payload));
+    IO::CANMessage changePDOMessage(0x48A, CHANGE_PDO_SIZE, payload, false);
+    txQueue.enqueue(changePDOMessage, CANTxQueue::Priority::STATE, true);
+    sentChangePDO = changePDO;
+
+    log::LOGGER.log<log::MessageID::STATE_CHANGE>(state, getStatus(STATUS_KEY), getStatus(STATUS_STO), getStatus(STATUS_BATTERY_ONE), getStatus(STATUS_BATTERY_TWO),
+                                                  getStatus(STATUS_ESTOP), getStatus(STATUS_APM), getStatus(STATUS_PC), getStatus(STATUS_DC),
+                                                  getStatus(STATUS_CONT), getStatus(STATUS_VOLT));
+}
+
+// The variants sharing this core
+template class PreChargeCore<PreCharge>;
+template class PreChargeCore<PreChargeKEV1N>;
+
+}// namespace PreCharge
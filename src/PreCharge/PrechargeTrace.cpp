@@ -0,0 +1,83 @@
+#include <PreCharge/PrechargeTrace.hpp>
+
+namespace PreCharge {
+
+PrechargeTrace::PrechargeTrace() {
+    for (uint8_t slot = 0; slot < NUM_ATTEMPTS; slot++) {
+        domains[slot].Offset = 0;
+        domains[slot].Start = reinterpret_cast<uint8_t*>(&attempts[slot]);
+        domains[slot].Size = sizeof(Attempt);
+    }
+}
+
+void PrechargeTrace::start(uint32_t now) {
+    finish(Result::ABORTED);
+
+    current = (current + 1) % NUM_ATTEMPTS;
+    Attempt& attempt = attempts[current];
+    attempt.sequence = ++sequence;
+    attempt.result = static_cast<uint8_t>(Result::RUNNING);
+    attempt.count = 0;
+    attempt.stride = 1;
+    attempt.timeSaved = 0;
+    attempt.startTime = now;
+}
+
+void PrechargeTrace::record(uint32_t elapsed, int32_t measured, int32_t expected, int32_t pack, bool keep) {
+    if (!isRunning()) {
+        return;
+    }
+    Attempt& attempt = attempts[current];
+    uint16_t time = elapsed > UINT16_MAX ? UINT16_MAX : elapsed;
+
+    Sample sample = {time, toCounts(measured), toCounts(expected), toCounts(pack)};
+
+    // The same sample can be checked more than once, keep the latest check
+    if (attempt.count > 0 && attempt.samples[attempt.count - 1].time == time) {
+        attempt.samples[attempt.count - 1] = sample;
+        return;
+    }
+
+    if (attempt.count > 0 && time - attempt.samples[attempt.count - 1].time < attempt.stride && !keep) {
+        return;
+    }
+
+    if (attempt.count == MAX_SAMPLES) {
+        // Full, halve the resolution of what has been recorded so far
+        for (uint8_t i = 0; i < MAX_SAMPLES / 2; i++) {
+            attempt.samples[i] = attempt.samples[2 * i];
+        }
+        attempt.count = MAX_SAMPLES / 2;
+        attempt.stride *= 2;
+    }
+    attempt.samples[attempt.count++] = sample;
+}
+
+void PrechargeTrace::finish(Result result, uint16_t timeSaved) {
+    if (isRunning()) {
+        attempts[current].result = static_cast<uint8_t>(result);
+        attempts[current].timeSaved = timeSaved;
+    }
+}
+
+bool PrechargeTrace::isRunning() const {
+    return attempts[current].result == static_cast<uint8_t>(Result::RUNNING);
+}
+
+const PrechargeTrace::Attempt& PrechargeTrace::getAttempt(uint8_t slot) const {
+    return attempts[slot];
+}
+
+CO_OBJ_DOM* PrechargeTrace::getDomain(uint8_t slot) {
+    return &domains[slot];
+}
+
+uint16_t PrechargeTrace::toCounts(int32_t millivolts) {
+    int32_t counts = millivolts / MV_PER_COUNT;
+    if (counts < 0) {
+        return 0;
+    }
+    return counts > UINT16_MAX ? UINT16_MAX : counts;
+}
+
+}// namespace PreCharge
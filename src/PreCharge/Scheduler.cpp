@@ -0,0 +1,102 @@
+#include <PreCharge/Scheduler.hpp>
+
+#include <EVT/utils/time.hpp>
+
+namespace time = EVT::core::time;
+
+namespace PreCharge {
+
+uint8_t Scheduler::addTask(Task task, void* priv, uint32_t period) {
+    if (numTasks == MAX_TASKS) {
+        return INVALID_TASK;
+    }
+
+    uint8_t id = numTasks++;
+    tasks[id] = {task, priv, period, time::millis() + period, {}};
+
+    // Insert into the dispatch order, after every task with a shorter or
+    // equal period so equal rates keep the order they were added in
+    uint8_t position = id;
+    while (position > 0) {
+        uint32_t otherPeriod = tasks[order[position - 1]].period;
+        if (period == 0 || (otherPeriod != 0 && otherPeriod <= period)) {
+            break;
+        }
+        order[position] = order[position - 1];
+        position--;
+    }
+    order[position] = id;
+
+    return id;
+}
+
+void Scheduler::runOnce() {
+    // Dispatch the highest rate due task, then look again from the top
+    bool ran = true;
+    while (ran) {
+        ran = false;
+        for (uint8_t i = 0; i < numTasks; i++) {
+            Entry& entry = tasks[order[i]];
+            if (entry.period == 0) {
+                break;
+            }
+
+            uint32_t start = time::millis();
+            if (static_cast<int32_t>(start - entry.release) < 0) {
+                continue;
+            }
+
+            uint32_t lateness = start - entry.release;
+            if (lateness > entry.stats.maxLateness) {
+                entry.stats.maxLateness = lateness;
+            }
+
+            // Every release that came around again before the task could
+            // start is a miss, and is skipped. The finish time is not used:
+            // at millisecond resolution a short task that merely crosses a
+            // tick would look like it overran. A real overrun shows up as
+            // the next start being late instead.
+            uint32_t missed = lateness / entry.period;
+            entry.stats.misses += missed;
+            entry.release += (missed + 1) * entry.period;
+            execute(entry);
+
+            ran = true;
+            break;
+        }
+    }
+
+    for (uint8_t i = 0; i < numTasks; i++) {
+        Entry& entry = tasks[order[i]];
+        if (entry.period == 0) {
+            execute(entry);
+        }
+    }
+}
+
+void Scheduler::run() {
+    while (true) {
+        runOnce();
+    }
+}
+
+const Scheduler::TaskStats& Scheduler::getStats(uint8_t id) const {
+    return tasks[id].stats;
+}
+
+uint8_t Scheduler::getNumTasks() const {
+    return numTasks;
+}
+
+void Scheduler::execute(Entry& entry) {
+    uint32_t start = time::millis();
+    entry.task(entry.priv);
+    uint32_t end = time::millis();
+
+    entry.stats.runs++;
+    if (end - start > entry.stats.maxRuntime) {
+        entry.stats.maxRuntime = end - start;
+    }
+}
+
+}// namespace PreCharge
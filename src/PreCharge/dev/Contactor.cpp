@@ -9,21 +9,97 @@ PreCharge::Contactor::Contactor(IO::GPIO& cont1, IO::GPIO& cont2) : cont1(cont1)
 }
 
 void PreCharge::Contactor::setOpen(bool shouldOpen) {
-    if (shouldOpen == isOpen) {
+    requestOpen(shouldOpen);
+    while (actuation != Actuation::IDLE) {
+        time::wait(1);
+        process();
+    }
+}
+
+void PreCharge::Contactor::requestOpen(bool shouldOpen) {
+    if (shouldOpen == targetOpen || (emergency && !shouldOpen)) {
         return;
     }
-    if (shouldOpen) {
-        cont1.writePin(IO::GPIO::State::HIGH);
-        time::wait(20);
+    targetOpen = shouldOpen;
+    requestTime = time::millis();
+
+    if (actuation == Actuation::PULSING) {
+        // Reversing before the current pulse finished, the new pulse is
+        // started by process() once the coil is released
+        actuation = Actuation::PENDING;
+    } else {
+        startPulse();
+    }
+}
+
+void PreCharge::Contactor::emergencyOpen() {
+    cont2.writePin(IO::GPIO::State::LOW);
+    cont1.writePin(IO::GPIO::State::HIGH);
+    emergency = true;
+}
+
+void PreCharge::Contactor::process() {
+    if (emergency) {
+        // Restart the pulse timing from here and drive the coils again, in
+        // case the interrupt landed between a pulse ending and its pins
+        // being released below
+        emergency = false;
+        targetOpen = true;
+        requestTime = time::millis();
+        cont2.writePin(IO::GPIO::State::LOW);
+        startPulse();
+        return;
+    }
+
+    if (actuation == Actuation::IDLE) {
+        return;
+    }
+
+    uint32_t now = time::millis();
+    if (now - pulseStartTime < PULSE_DURATION) {
+        return;
+    }
+
+    if (pulsingOpen) {
         cont1.writePin(IO::GPIO::State::LOW);
     } else {
-        cont2.writePin(IO::GPIO::State::HIGH);
-        time::wait(20);
         cont2.writePin(IO::GPIO::State::LOW);
     }
-    isOpen = shouldOpen;
+    isOpen = pulsingOpen;
+
+    if (targetOpen != isOpen) {
+        startPulse();
+    } else {
+        actuationTime = now - requestTime;
+        actuation = Actuation::IDLE;
+    }
+}
+
+PreCharge::Contactor::Actuation PreCharge::Contactor::getActuation() {
+    return actuation;
+}
+
+uint32_t PreCharge::Contactor::getActuationTime() {
+    return actuationTime;
 }
 
 bool PreCharge::Contactor::openState() {
     return isOpen;
 }
+
+void PreCharge::Contactor::startPulse() {
+    pulsingOpen = targetOpen;
+    pulseStartTime = time::millis();
+    if (pulsingOpen) {
+        cont1.writePin(IO::GPIO::State::HIGH);
+    } else {
+        cont2.writePin(IO::GPIO::State::HIGH);
+        // emergencyOpen() may have driven cont1 after the caller checked for
+        // it, release cont2 at once rather than hold both coils until the
+        // next process()
+        if (emergency) {
+            cont2.writePin(IO::GPIO::State::LOW);
+        }
+    }
+    actuation = Actuation::PULSING;
+}
@@ -2,18 +2,96 @@
 
 namespace PreCharge {
 
-MAX22530::MAX22530(IO::SPI& SPI) : spi(SPI) {}
+MAX22530::MAX22530(IO::SPI& SPI) : spi(SPI) {
+    for (uint8_t reg = 0x01; reg <= NUM_CHANNELS; reg++) {
+        setCalibration(reg, UNITY_GAIN, 0);
+    }
+}
 
-uint8_t MAX22530::convertToVoltage(uint16_t count) {     // count is out of 4096
-    uint8_t result = (((uint32_t) count) * 1098) / 40960;// 1.8 * 61 (* 10 for 1.8 to make it fixed point) 1.8 is the reference voltage, 61 is voltage divider ratio
-    return result;                                       // returns in dV
+void MAX22530::setCalibration(uint16_t reg, uint32_t gain, int32_t offset) {
+    // Fold the calibration gain into the conversion gain once here so each
+    // conversion is a single multiply
+    scale[reg - 1] = (static_cast<uint64_t>(NOMINAL_GAIN) * gain) >> 16;
+    this->offset[reg - 1] = offset;
 }
 
-uint8_t MAX22530::readVoltage(uint16_t reg) {
-    reg = reg << 2;
+uint8_t MAX22530::convertToVoltage(int32_t millivolts) {
+    if (millivolts <= 0) {
+        return 0;
+    }
+    // Divide by 1000 as a multiply by 2^32 / 1000 (rounded up) and shift,
+    // exact over the range of the ADC
+    uint32_t result = (static_cast<uint64_t>(millivolts) * 4294968) >> 32;
+    return result > UINT8_MAX ? UINT8_MAX : result;
+}
+
+int32_t MAX22530::readMillivolts(uint16_t reg) {
     uint8_t bytes[2];
-    spi.readReg(0, reg, bytes, 2);
-    return convertToVoltage((bytes[0] << 8) | bytes[1]);
+    spi.readReg(0, reg << 2, bytes, 2);
+    return convertToMillivolts(reg, (bytes[0] << 8) | bytes[1]);
+}
+
+uint8_t MAX22530::readVoltage(uint16_t reg) {
+    return convertToVoltage(readMillivolts(reg));
+}
+
+IO::SPI::SPIStatus MAX22530::readChannels(uint8_t mask, Sample& sample) {
+    uint32_t start = CycleCounter::now();
+    IO::SPI::SPIStatus status = burstRead(mask, sample);
+    readStats.record(CycleCounter::now() - start);
+    return status;
+}
+
+IO::SPI::SPIStatus MAX22530::burstRead(uint8_t mask, Sample& sample) {
+    mask &= ALL_CHANNELS;
+    if (mask == 0) {
+        return IO::SPI::SPIStatus::OK;
+    }
+
+    uint8_t first = 0;
+    while (!(mask & (1 << first))) {
+        first++;
+    }
+    uint8_t last = NUM_CHANNELS - 1;
+    while (!(mask & (1 << last))) {
+        last--;
+    }
+    uint8_t count = last - first + 1;
+
+    // Address in bits 7:2, read in bit 1 and the burst flag in bit 0 so the
+    // registers after the first are clocked out in the same transaction
+    uint8_t command = ((first + 1) << 2) | (count > 1 ? 0x01 : 0x00);
+    uint8_t bytes[NUM_CHANNELS * 2];
+    IO::SPI::SPIStatus status = spi.readReg(0, command, bytes, count * 2);
+    if (status != IO::SPI::SPIStatus::OK) {
+        return status;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t channel = first + i;
+        if (mask & (1 << channel)) {
+            sample.counts[channel] = (bytes[i * 2] << 8) | bytes[i * 2 + 1];
+        }
+    }
+    sample.mask = mask;
+
+    return status;
+}
+
+IO::SPI::SPIStatus MAX22530::readAll(Sample& sample) {
+    return readChannels(ALL_CHANNELS, sample);
+}
+
+int32_t MAX22530::getMillivolts(const Sample& sample, uint16_t reg) const {
+    return convertToMillivolts(reg, sample.counts[reg - 1]);
+}
+
+uint8_t MAX22530::getVoltage(const Sample& sample, uint16_t reg) const {
+    return convertToVoltage(getMillivolts(sample, reg));
+}
+
+const CycleStats& MAX22530::getReadStats() const {
+    return readStats;
 }
 
 }// namespace PreCharge
@@ -0,0 +1,85 @@
+#include <PreCharge/dev/MAX22530Sampler.hpp>
+
+#include <EVT/utils/time.hpp>
+
+namespace time = EVT::core::time;
+
+namespace PreCharge {
+
+MAX22530Sampler* MAX22530Sampler::timerSampler = nullptr;
+
+MAX22530Sampler::MAX22530Sampler(MAX22530& max, uint8_t mask) : max(max), mask(mask) {}
+
+void MAX22530Sampler::start(DEV::Timer& timer) {
+    this->timer = &timer;
+    timerSampler = this;
+    startTime = time::millis();
+    running = true;
+    timer.startTimer(timerIRQHandler);
+}
+
+void MAX22530Sampler::start(IO::GPIO& dataReady) {
+    timer = nullptr;
+    startTime = time::millis();
+    running = true;
+    dataReady.registerIRQ(IO::GPIO::TriggerEdge::FALLING, dataReadyIRQHandler, this);
+}
+
+void MAX22530Sampler::stop() {
+    running = false;
+    if (timer != nullptr) {
+        timer->stopTimer();
+    }
+}
+
+bool MAX22530Sampler::isRunning() const {
+    return running;
+}
+
+void MAX22530Sampler::sample() {
+    if (!running) {
+        return;
+    }
+
+    TimedSample timedSample = {};
+    timedSample.timestamp = time::millis();
+    if (max.readChannels(mask, timedSample.sample) != IO::SPI::SPIStatus::OK) {
+        errorCount++;
+        return;
+    }
+
+    sampleCount++;
+    queue.push(timedSample);
+}
+
+bool MAX22530Sampler::pop(TimedSample& timedSample) {
+    return queue.pop(timedSample);
+}
+
+uint32_t MAX22530Sampler::getStartTime() const {
+    return startTime;
+}
+
+uint32_t MAX22530Sampler::getSampleCount() const {
+    return sampleCount;
+}
+
+uint32_t MAX22530Sampler::getOverrunCount() const {
+    return queue.getOverrunCount();
+}
+
+uint32_t MAX22530Sampler::getErrorCount() const {
+    return errorCount;
+}
+
+void MAX22530Sampler::timerIRQHandler(void* htim) {
+    if (timerSampler != nullptr) {
+        timerSampler->sample();
+    }
+}
+
+void MAX22530Sampler::dataReadyIRQHandler(IO::GPIO* pin, void* priv) {
+    static_cast<MAX22530Sampler*>(priv)->sample();
+}
+
+}// namespace PreCharge
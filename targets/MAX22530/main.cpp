@@ -33,9 +33,17 @@ int main() {
 
     PreCharge::MAX22530 MAX(spi);
 
+    PreCharge::MAX22530::Sample sample;
+
     while (1) {
         for (int reg = 0x01; reg <= 0x04; reg++) {
             uart.printf("Register 0x%x: %d\r\n", reg, MAX.readVoltage(reg));
         }
+
+        // Same channels again, sampled together in one burst
+        MAX.readAll(sample);
+        for (int reg = 0x01; reg <= 0x04; reg++) {
+            uart.printf("Burst 0x%x: %d mV\r\n", reg, MAX.getMillivolts(sample, reg));
+        }
     }
 }
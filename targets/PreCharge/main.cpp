@@ -8,45 +8,104 @@
 #include <EVT/io/types/CANMessage.hpp>
 #include <EVT/manager.hpp>
 #include <EVT/utils/log.hpp>
-#include <EVT/utils/types/FixedQueue.hpp>
 
+#include <PreCharge/BinaryLog.hpp>
 #include <PreCharge/GFDB.hpp>
 #include <PreCharge/PreCharge.hpp>
+#include <PreCharge/Scheduler.hpp>
 
 namespace IO = EVT::core::IO;
 namespace DEV = EVT::core::DEV;
 namespace time = EVT::core::time;
 
+///////////////////////////////////////////////////////////////////////////////
+// Scheduler tasks. The safety inputs and state machine run every millisecond,
+// the ADC every 10 ms and the GFDB readings are refreshed every second, while
+// CANopen and the GFDB requests are serviced on every pass.
+///////////////////////////////////////////////////////////////////////////////
+
+struct CANopenTaskParams {
+    CO_NODE* node;
+    GFDB::GFDB* gfdb;
+    PreCharge::CANTxQueue* txQueue;
+};
+
+void safetyTask(void* priv) {
+    static_cast<PreCharge::PreCharge*>(priv)->handleSafety();
+}
+
+void adcTask(void* priv) {
+    static_cast<PreCharge::PreCharge*>(priv)->handleADC();
+}
+
+void gfdbTask(void* priv) {
+    static_cast<PreCharge::PreCharge*>(priv)->handleGFDB();
+}
+
+void canopenTask(void* priv) {
+    auto* params = static_cast<CANopenTaskParams*>(priv);
+
+    // Process incoming CAN messages
+    CONodeProcess(params->node);
+    // Update the state of timer based events
+    COTmrService(&params->node->Tmr);
+    // Handle executing timer events that have elapsed
+    COTmrProcess(&params->node->Tmr);
+    // Send queued GFDB requests and collect their responses
+    params->gfdb->process();
+    // Send what the state machine could not get out on its own pass
+    params->txQueue->drain();
+}
+
+struct LoggingTaskParams {
+    PreCharge::Scheduler* scheduler;
+    IO::UART* uart;
+};
+
+/**
+ * Background task reporting tasks that have started missing deadlines and
+ * writing the log out to the UART as its transmitter frees up
+ */
+void loggingTask(void* priv) {
+    auto* params = static_cast<LoggingTaskParams*>(priv);
+    static uint32_t reportedMisses[PreCharge::Scheduler::MAX_TASKS] = {};
+
+    for (uint8_t i = 0; i < params->scheduler->getNumTasks(); i++) {
+        uint32_t misses = params->scheduler->getStats(i).misses;
+        if (misses != reportedMisses[i]) {
+            PreCharge::log::LOGGER.log<PreCharge::log::MessageID::TASK_MISSED>(i, misses);
+            reportedMisses[i] = misses;
+        }
+    }
+
+    PreCharge::log::LOGGER.drain(*params->uart);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // EVT-core CAN callback and CAN setup. This will include logic to set
 // aside CANopen messages into a specific queue
 ///////////////////////////////////////////////////////////////////////////////
 
 struct CANInterruptParams {
-    EVT::core::types::FixedQueue<CANOPEN_QUEUE_SIZE, IO::CANMessage>* queue;
-    IO::CANf3xx* can;
+    PreCharge::CANDispatcher* dispatcher;
 };
 
+
 /**
 * Interrupt handler to get CAN messages. A function pointer to this function
 * will be passed to the EVT-core CAN interface which will in turn call this
 * function each time a new CAN message comes in.
 *
-* NOTE: For this sample, every non-extended (so 11 bit CAN IDs) will be
-* assummed to be intended to be passed as a CANopen message.
+* Every frame goes through the pre-charge controller's receive filter, which
+* passes this node's CANopen frames to its CANopen queue and the GFDB
+* responses to the GFDB, and rejects the rest of the bus traffic.
 *
 * @param message[in] The passed in CAN message that was read.
 */
 void canInterruptHandler(IO::CANMessage& message, void* priv) {
     auto* canStruct = (struct CANInterruptParams*) priv;
-    if (message.isCANExtended()) {
-        if (canStruct != nullptr && canStruct->can != nullptr) {
-            canStruct->can->addCANMessage(message);
-        }
-    } else {
-        if (canStruct != nullptr && canStruct->queue != nullptr) {
-            canStruct->queue->append(message);
-        }
+    if (canStruct != nullptr && canStruct->dispatcher != nullptr) {
+        canStruct->dispatcher->dispatch(message);
     }
 }
 
@@ -54,14 +113,12 @@ int main() {
     // Initialize system
     EVT::core::platform::init();
 
-    // Queue that will store CANopen messages
-    EVT::core::types::FixedQueue<CANOPEN_QUEUE_SIZE, IO::CANMessage> canOpenQueue;
-
-    // Initialize CAN, add an IRQ that will populate the above queue
+    // Initialize CAN, add an IRQ that hands the messages to the pre-charge
+    // controller's receive filter once it is up. CANopen messages end up in
+    // its CANopen queue.
     IO::CAN& can = IO::getCAN<PreCharge::PreCharge::CAN_TX_PIN, PreCharge::PreCharge::CAN_RX_PIN>();
     struct CANInterruptParams canParams = {
-        .queue = &canOpenQueue,
-        .can = static_cast<IO::CANf3xx*>(&can),
+        .dispatcher = nullptr,
     };
     can.addIRQHandler(canInterruptHandler, reinterpret_cast<void*>(&canParams));
 
@@ -81,6 +138,9 @@ int main() {
     EVT::core::log::LOGGER.setUART(&uart);
     EVT::core::log::LOGGER.setLogLevel(EVT::core::log::Logger::LogLevel::DEBUG);
     EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::DEBUG, "Logger initialized.");
+    // Everything after start up goes through the binary log, read it with
+    // the LogDecoder host target
+    PreCharge::log::LOGGER.setFormat(PreCharge::log::BinaryLog::Format::BINARY);
     timer.stopTimer();
 
     // Reserved memory for CANopen stack usage
@@ -109,6 +169,11 @@ int main() {
     //    IO::GPIO& forward = IO::getGPIO<IO::Pin::PA_3>(IO::GPIO::Direction::OUTPUT);
     GFDB::GFDB gfdb(can);
     PreCharge::PreCharge precharge(key, batteryOne, batteryTwo, eStop, pc, dc, cont, apm, gfdb, can, MAX);
+    canParams.dispatcher = &precharge.getCANDispatcher();
+
+    // Sample the ADC at 1 kHz from a hardware timer instead of once per loop
+    DEV::Timer& adcTimer = DEV::getTimer<DEV::MCUTimer::Timer15>(1);
+    precharge.getSampler().start(adcTimer);
 
     ///////////////////////////////////////////////////////////////////////////
     // Setup CAN configuration, this handles making drivers, applying settings.
@@ -126,8 +191,15 @@ int main() {
 
     CO_NODE canNode;
 
-    // Initialize all the CANOpen drivers.
-    IO::initializeCANopenDriver(&canOpenQueue, &can, &timer, &canStackDriver, &nvmDriver, &timerDriver, &canDriver);
+    // Initialize all the CANOpen drivers. The CAN driver reads from the
+    // pre-charge controller's CANopen queue.
+    precharge.getCANopenQueue().getDriver(can, &canDriver);
+    IO::getCANopenTimerDriver(&timer, &timerDriver);
+    IO::getCANopenNVMDriver(&nvmDriver);
+
+    canStackDriver.Can = &canDriver;
+    canStackDriver.Timer = &timerDriver;
+    canStackDriver.Nvm = &nvmDriver;
 
     // Initialize the CANOpen node we are using.
     IO::initializeCANopenNode(&canNode, &precharge, &canStackDriver, sdoBuffer, appTmrMem);
@@ -143,16 +215,25 @@ int main() {
     pc.writePin(IO::GPIO::State::LOW);
     dc.writePin(IO::GPIO::State::LOW);
 
-    while (1) {
-        PreCharge::PreCharge::PVCStatus current_status = precharge.handle();// Update state machine
+    // React to the e-stop from its interrupt rather than the safety task
+    precharge.enableEStopInterrupt();
 
-        // Process incoming CAN messages
-        CONodeProcess(&canNode);
-        // Update the state of timer based events
-        COTmrService(&canNode.Tmr);
-        // Handle executing timer events that have elapsed
-        COTmrProcess(&canNode.Tmr);
+    CANopenTaskParams canopenParams = {
+        .node = &canNode,
+        .gfdb = &gfdb,
+        .txQueue = &precharge.getTxQueue(),
+    };
 
-        time::wait(100);// May not be necessary
-    }
+    PreCharge::Scheduler scheduler;
+    LoggingTaskParams loggingParams = {
+        .scheduler = &scheduler,
+        .uart = &uart,
+    };
+    scheduler.addTask(safetyTask, &precharge, 1);
+    scheduler.addTask(adcTask, &precharge, 10);
+    scheduler.addTask(gfdbTask, &precharge, GFDB::GFDBPoller::ISOLATION_STATE_PERIOD);
+    scheduler.addTask(canopenTask, &canopenParams, 0);
+    scheduler.addTask(loggingTask, &loggingParams, 0);
+
+    scheduler.run();
 }
\ No newline at end of file
@@ -8,8 +8,8 @@
 #include <EVT/io/types/CANMessage.hpp>
 #include <EVT/manager.hpp>
 #include <EVT/utils/log.hpp>
-#include <EVT/utils/types/FixedQueue.hpp>
 
+#include <PreCharge/BinaryLog.hpp>
 #include <PreCharge/GFDB.hpp>
 #include <PreCharge/PreChargeKEV1N.hpp>
 
@@ -23,30 +23,25 @@ namespace time = EVT::core::time;
 ///////////////////////////////////////////////////////////////////////////////
 
 struct CANInterruptParams {
-    EVT::core::types::FixedQueue<CANOPEN_QUEUE_SIZE, IO::CANMessage>* queue;
-    IO::CANf3xx* can;
+    PreCharge::CANDispatcher* dispatcher;
 };
 
+
 /**
 * Interrupt handler to get CAN messages. A function pointer to this function
 * will be passed to the EVT-core CAN interface which will in turn call this
 * function each time a new CAN message comes in.
 *
-* NOTE: For this sample, every non-extended (so 11 bit CAN IDs) will be
-* assummed to be intended to be passed as a CANopen message.
+* Every frame goes through the pre-charge controller's receive filter, which
+* passes this node's CANopen frames to its CANopen queue and the GFDB
+* responses to the GFDB, and rejects the rest of the bus traffic.
 *
 * @param message[in] The passed in CAN message that was read.
 */
 void canInterruptHandler(IO::CANMessage& message, void* priv) {
     auto* canStruct = (struct CANInterruptParams*) priv;
-    if (message.isCANExtended()) {
-        if (canStruct != nullptr && canStruct->can != nullptr) {
-            canStruct->can->addCANMessage(message);
-        }
-    } else {
-        if (canStruct != nullptr && canStruct->queue != nullptr) {
-            canStruct->queue->append(message);
-        }
+    if (canStruct != nullptr && canStruct->dispatcher != nullptr) {
+        canStruct->dispatcher->dispatch(message);
     }
 }
 
@@ -61,14 +56,12 @@ int main() {
     // Initialize system
     EVT::core::platform::init();
 
-    // Queue that will store CANopen messages
-    EVT::core::types::FixedQueue<CANOPEN_QUEUE_SIZE, IO::CANMessage> canOpenQueue;
-
-    // Initialize CAN, add an IRQ that will populate the above queue
+    // Initialize CAN, add an IRQ that hands the messages to the pre-charge
+    // controller's receive filter once it is up. CANopen messages end up in
+    // its CANopen queue.
     IO::CAN& can = IO::getCAN<PreCharge::PreChargeKEV1N::CAN_TX_PIN, PreCharge::PreChargeKEV1N::CAN_RX_PIN>();
     struct CANInterruptParams canParams = {
-        .queue = &canOpenQueue,
-        .can = static_cast<IO::CANf3xx*>(&can),
+        .dispatcher = nullptr,
     };
     can.addIRQHandler(canInterruptHandler, reinterpret_cast<void*>(&canParams));
 
@@ -88,6 +81,9 @@ int main() {
     EVT::core::log::LOGGER.setUART(&uart);
     EVT::core::log::LOGGER.setLogLevel(EVT::core::log::Logger::LogLevel::DEBUG);
     EVT::core::log::LOGGER.log(EVT::core::log::Logger::LogLevel::DEBUG, "Logger initialized.");
+    // Everything after start up goes through the binary log, read it with
+    // the LogDecoder host target
+    PreCharge::log::LOGGER.setFormat(PreCharge::log::BinaryLog::Format::BINARY);
     timer.stopTimer();
 
     // Reserved memory for CANopen stack usage
@@ -116,6 +112,7 @@ int main() {
     //    IO::GPIO& forward = IO::getGPIO<IO::Pin::PA_3>(IO::GPIO::Direction::OUTPUT);
     GFDB::GFDB gfdb(can);
     PreCharge::PreChargeKEV1N precharge(key, batteryOne, batteryTwo, eStop, pc, dc, cont, apm, gfdb, can, MAX);
+    canParams.dispatcher = &precharge.getCANDispatcher();
 
     ///////////////////////////////////////////////////////////////////////////
     // Setup CAN configuration, this handles making drivers, applying settings.
@@ -129,7 +126,7 @@ int main() {
     CO_IF_TIMER_DRV timerDriver;
     CO_IF_NVM_DRV nvmDriver;
 
-    IO::getCANopenCANDriver(&can, &canOpenQueue, &canDriver);
+    precharge.getCANopenQueue().getDriver(can, &canDriver);
     IO::getCANopenTimerDriver(&timer, &timerDriver);
     IO::getCANopenNVMDriver(&nvmDriver);
 
@@ -180,6 +177,12 @@ int main() {
         // Handle executing timer events that have elapsed
         COTmrProcess(&canNode.Tmr);
 
-        time::wait(100);// May not be necessary
+        // Write the log out while waiting for the next pass, instead of
+        // time::wait(100)
+        uint32_t passStart = time::millis();
+        while (time::millis() - passStart < 100) {
+            precharge.getTxQueue().drain();
+            PreCharge::log::LOGGER.drain(uart);
+        }
     }
 }
\ No newline at end of file